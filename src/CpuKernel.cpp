@@ -0,0 +1,52 @@
+#include "CpuKernel.hpp"
+#include "CpuKernelImpl.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+// compiled with the flags of the whole program, runs on any processor it is built for
+const CpuKernel CpuKernel::scalar{ Simd::instructionSet, _iterate };
+
+namespace
+{
+    // the processor has the instructions and the system saves their registers
+    bool _supports(bool avx512)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        bool fma = (info[2] & (1 << 12)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!fma || !osxsave)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        // ymm registers, with AVX-512 also the mask and zmm registers
+        unsigned long long xcr0 = _xgetbv(0);
+        if (avx512)
+            return (info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+        return (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (avx512)
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("fma");
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+        return false;
+#endif
+    }
+}
+
+const CpuKernel& CpuKernel::best()
+{
+    static const CpuKernel& kernel
+        = avx512.iterate && _supports(true) ? avx512
+        : avx2.iterate && _supports(false) ? avx2
+        : scalar;
+    return kernel;
+}
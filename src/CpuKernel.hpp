@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CpuRenderer.hpp"
+
+/// <summary>
+/// Iteration of the pixels of the CPU renderer with the SIMD packs of one instruction set. Each instruction set is
+/// compiled in its own file with the flags that enable it and the widest one the processor supports is chosen at runtime
+/// </summary>
+struct CpuKernel
+{
+    /// <summary>
+    /// Does the iterations from iterStart to iterEnd for the pixels at the given indices of the state
+    /// </summary>
+    using Iterate = void (*)(const CpuFractalParams& params, int iterStart, int iterEnd, int width, int height,
+        const int* pixels, int count, double* zState, int* iterState, int* refState);
+
+    // name of the instruction set
+    const char* instructionSet;
+    // nullptr if the file of the instruction set wasn't compiled with it
+    Iterate iterate;
+
+    static const CpuKernel scalar;
+    static const CpuKernel avx2;
+    static const CpuKernel avx512;
+
+    /// <summary>
+    /// Gets the kernel of the widest instruction set that was compiled and that the processor supports
+    /// </summary>
+    /// <returns>The kernel</returns>
+    static const CpuKernel& best();
+};
@@ -0,0 +1,14 @@
+#include "CpuKernel.hpp"
+
+// the file is compiled with AVX2 and FMA enabled (-mavx2 -mfma, /arch:AVX2)
+#if defined(__AVX2__)
+
+#include "CpuKernelImpl.hpp"
+
+const CpuKernel CpuKernel::avx2{ Simd::instructionSet, _iterate };
+
+#else
+
+const CpuKernel CpuKernel::avx2{ "AVX2", nullptr };
+
+#endif
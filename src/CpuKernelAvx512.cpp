@@ -0,0 +1,14 @@
+#include "CpuKernel.hpp"
+
+// the file is compiled with AVX-512 and FMA enabled (-mavx512f -mfma, /arch:AVX512)
+#if defined(__AVX512F__)
+
+#include "CpuKernelImpl.hpp"
+
+const CpuKernel CpuKernel::avx512{ Simd::instructionSet, _iterate };
+
+#else
+
+const CpuKernel CpuKernel::avx512{ "AVX-512", nullptr };
+
+#endif
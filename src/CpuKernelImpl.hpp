@@ -0,0 +1,421 @@
+#pragma once
+
+// Iteration code of the CPU renderer, included by the file of each instruction set and compiled with its flags.
+// Everything here has internal linkage and the packs of Simd.hpp are in a namespace of the instruction set,
+// so the linker can't pick a function compiled with a wider instruction set for the code that runs on any processor
+
+#include "CpuKernel.hpp"
+#include "Simd.hpp"
+
+namespace
+{
+    template<typename P>
+    struct _ComplexPack
+    {
+        P x;
+        P y;
+    };
+
+    template<typename P>
+    _ComplexPack<P> _cAdd(_ComplexPack<P> a, _ComplexPack<P> b)
+    {
+        return _ComplexPack<P>{ a.x + b.x, a.y + b.y };
+    }
+
+    template<typename P>
+    _ComplexPack<P> _cSub(_ComplexPack<P> a, _ComplexPack<P> b)
+    {
+        return _ComplexPack<P>{ a.x - b.x, a.y - b.y };
+    }
+
+    template<typename P>
+    _ComplexPack<P> _cMul(_ComplexPack<P> a, _ComplexPack<P> b)
+    {
+        return _ComplexPack<P>{
+            a.x * b.x - a.y * b.y,
+            a.x * b.y + a.y * b.x
+        };
+    }
+
+    template<typename P>
+    _ComplexPack<P> _cDiv(_ComplexPack<P> a, _ComplexPack<P> b)
+    {
+        P div = b.x * b.x + b.y * b.y;
+        return _ComplexPack<P>{
+            (a.x * b.x + a.y * b.y) / div,
+            (a.y * b.x - a.x * b.y) / div
+        };
+    }
+
+    // fractal parameters converted to packs, shared by all pixels of a tile
+    template<typename P>
+    struct _Kernel
+    {
+        using Pack = P;
+        using T = typename P::Scalar;
+
+        GLFractal::Fractal fractal;
+        int iterStart;
+        int iterEnd;
+
+        _ComplexPack<P> adder;
+        _ComplexPack<P> multiplier;
+        // squared
+        P periodTolerance;
+
+        int rootCount;
+        _ComplexPack<P> roots[10];
+
+        int coefCount;
+        _ComplexPack<P> coefs[11];
+        // coefficients of the derivative
+        _ComplexPack<P> derivCoefs[10];
+
+        bool perturbation;
+        const double* orbit;
+        int orbitLength;
+
+        _Kernel(const CpuFractalParams& params, int iterStart, int iterEnd)
+            : fractal(params.fractal)
+            , iterStart(iterStart)
+            , iterEnd(iterEnd)
+            , rootCount(params.rootCount)
+            , coefCount(params.coefCount)
+            , perturbation(params.perturbation)
+            , orbit(params.orbit)
+            , orbitLength(params.orbitLength)
+        {
+            adder = _ComplexPack<P>{ P::broadcast((T)params.adder.x), P::broadcast((T)params.adder.y) };
+            multiplier = _ComplexPack<P>{ P::broadcast((T)params.multiplier.x), P::broadcast((T)params.multiplier.y) };
+            periodTolerance = P::broadcast((T)(params.periodTolerance * params.periodTolerance));
+
+            for (int i = 0; i < rootCount; i++)
+                roots[i] = _ComplexPack<P>{ P::broadcast((T)params.roots[i].x), P::broadcast((T)params.roots[i].y) };
+
+            for (int i = 0; i < coefCount; i++)
+                coefs[i] = _ComplexPack<P>{ P::broadcast((T)params.coefs[i].x), P::broadcast((T)params.coefs[i].y) };
+
+            int coefc = coefCount - 1;
+            for (int i = 0; i < coefc; i++)
+            {
+                float d = (float)(coefc - i);
+                derivCoefs[i] = _ComplexPack<P>{ P::broadcast((T)(params.coefs[i].x * d)), P::broadcast((T)(params.coefs[i].y * d)) };
+            }
+        }
+
+        _ComplexPack<P> fun(_ComplexPack<P> z) const
+        {
+            _ComplexPack<P> res = coefs[0];
+            for (int i = 1; i < coefCount; i++)
+                res = _cAdd(_cMul(res, z), coefs[i]);
+            return res;
+        }
+
+        _ComplexPack<P> deriv(_ComplexPack<P> z) const
+        {
+            _ComplexPack<P> res = derivCoefs[0];
+            for (int i = 1; i < coefCount - 1; i++)
+                res = _cAdd(_cMul(res, z), derivCoefs[i]);
+            return res;
+        }
+
+        // finds the closest root, returns its index and squared distance
+        void closestRoot(_ComplexPack<P> z, P& c, P& dist) const
+        {
+            _ComplexPack<P> d = _cSub(roots[0], z);
+            dist = d.x * d.x + d.y * d.y;
+            c = P::broadcast(0);
+            for (int j = 1; j < rootCount; j++)
+            {
+                d = _cSub(roots[j], z);
+                P newDist = d.x * d.x + d.y * d.y;
+                auto closer = less(newDist, dist);
+                dist = select(closer, newDist, dist);
+                c = select(closer, P::broadcast((T)j), c);
+            }
+        }
+
+        // mandelbrot and julia set
+        void escapeTime(_ComplexPack<P>& z, _ComplexPack<P> c, P& iter, P& result) const
+        {
+            const P zero = P::broadcast(0);
+            const P one = P::broadcast(1);
+            const P two = P::broadcast(2);
+            const P four = P::broadcast(4);
+
+            // Brent's cycle detection, z is compared with a saved z that is moved after 1, 2, 4, 8... iterations
+            _ComplexPack<P> saved = z;
+            int savedAfter = 1;
+            int sinceSaved = 0;
+
+            auto active = !greater(result, zero);
+            for (int i = iterStart; i < iterEnd && any(active); i++)
+            {
+                P x = (z.x * z.x - z.y * z.y) + c.x;
+                P y = (z.y * z.x + z.x * z.y) + c.y;
+
+                auto escaped = active & greater(x * x + y * y, four);
+                result = select(escaped, one, result);
+                active = active & !escaped;
+
+                z.x = select(active, x, z.x);
+                z.y = select(active, y, z.y);
+
+                _ComplexPack<P> d = _cSub(z, saved);
+                auto cycling = active & less(d.x * d.x + d.y * d.y, periodTolerance);
+                result = select(cycling, two, result);
+                active = active & !cycling;
+
+                iter = select(active, iter + one, iter);
+
+                if (++sinceSaved == savedAfter)
+                {
+                    saved = z;
+                    sinceSaved = 0;
+                    savedAfter *= 2;
+                }
+            }
+        }
+
+        // gets the points of the reference orbit at the index of each lane
+        _ComplexPack<P> orbitPoint(P index) const
+        {
+            T indices[P::lanes];
+            T x[P::lanes];
+            T y[P::lanes];
+            index.store(indices);
+            for (int l = 0; l < P::lanes; l++)
+            {
+                x[l] = (T)orbit[(int)indices[l] * 2];
+                y[l] = (T)orbit[(int)indices[l] * 2 + 1];
+            }
+            return _ComplexPack<P>{ P::load(x), P::load(y) };
+        }
+
+        // mandelbrot set as difference dz from the reference orbit, z = orbit[ref] + dz
+        void perturb(_ComplexPack<P>& dz, _ComplexPack<P> dc, P& ref, P& iter, P& result) const
+        {
+            const P zero = P::broadcast(0);
+            const P one = P::broadcast(1);
+            const P two = P::broadcast(2);
+            const P four = P::broadcast(4);
+            const P last = P::broadcast((T)(orbitLength - 1));
+            const P end = P::broadcast((T)iterEnd);
+
+            // pixels can start after the iterations skipped by the series
+            auto active = (!greater(result, zero)) & less(iter, end);
+            while (any(active))
+            {
+                // z^2 + c - (Z^2 + C) = 2 * Z * dz + dz^2 + dc
+                _ComplexPack<P> point = orbitPoint(ref);
+                _ComplexPack<P> next{
+                    two * (point.x * dz.x - point.y * dz.y) + (dz.x * dz.x - dz.y * dz.y) + dc.x,
+                    two * (point.x * dz.y + point.y * dz.x) + two * dz.x * dz.y + dc.y
+                };
+                P nextRef = ref + one;
+
+                _ComplexPack<P> z = _cAdd(orbitPoint(nextRef), next);
+                P dist = z.x * z.x + z.y * z.y;
+
+                auto escaped = active & greater(dist, four);
+                result = select(escaped, one, result);
+                active = active & !escaped;
+
+                // going back to the start of the orbit when the pixel gets closer to 0 than to the reference
+                auto rebase = less(dist, next.x * next.x + next.y * next.y) | !less(nextRef, last);
+                dz.x = select(active, select(rebase, z.x, next.x), dz.x);
+                dz.y = select(active, select(rebase, z.y, next.y), dz.y);
+                ref = select(active, select(rebase, zero, nextRef), ref);
+                iter = select(active, iter + one, iter);
+                active = active & less(iter, end);
+            }
+        }
+
+        void newton(_ComplexPack<P>& z, P& iter, P& result) const
+        {
+            const P zero = P::broadcast(0);
+            const P one = P::broadcast(1);
+            // distance 0.0001 squared
+            const P epsilon = P::broadcast((T)1e-8);
+
+            auto active = !greater(result, zero);
+            for (int i = iterStart; i < iterEnd && any(active); i++)
+            {
+                iter = select(active, iter + one, iter);
+
+                _ComplexPack<P> next = _cSub(z, _cDiv(fun(z), deriv(z)));
+                z.x = select(active, next.x, z.x);
+                z.y = select(active, next.y, z.y);
+
+                // root index is stored with offset so that 0 means not converged
+                P c, dist;
+                closestRoot(z, c, dist);
+                auto converged = active & less(dist, epsilon);
+                result = select(converged, c + one, result);
+                active = active & !converged;
+            }
+        }
+
+        void nova(_ComplexPack<P>& z, P& iter, P& result) const
+        {
+            if (iterStart >= iterEnd)
+                return;
+
+            for (int i = iterStart; i < iterEnd; i++)
+                z = _cSub(_cSub(z, _cMul(multiplier, _cDiv(fun(z), deriv(z)))), adder);
+
+            P c, dist;
+            closestRoot(z, c, dist);
+            iter = P::broadcast((T)iterEnd);
+            result = c + P::broadcast(1);
+        }
+    };
+
+    // iterates 'count' pixels at the given indices (count <= number of lanes)
+    template<typename P>
+    void _iterateGroup(const _Kernel<P>& kernel, const CpuFractalParams& params, int width, int height,
+        const int* pixels, int count, double* zState, int* iterState, int* refState)
+    {
+        using T = typename P::Scalar;
+        const int N = P::lanes;
+
+        T cx[N];
+        T cy[N];
+        T zx[N];
+        T zy[N];
+        T iter[N];
+        T result[N];
+        T ref[N];
+
+        for (int l = 0; l < N; l++)
+        {
+            // lanes past the end of the group repeat the last pixel
+            int index = pixels[l < count ? l : count - 1];
+            int px = index % width;
+            int y = index / width;
+
+            // same mapping as the texture coordinates of the main view (the scale spans the width),
+            // with perturbation only the distance from the center is needed
+            cx[l] = ((T)px + (T)0.5 - (T)width / 2) / (T)width * (T)params.scale;
+            cy[l] = ((T)y + (T)0.5 - (T)height / 2) / (T)width * (T)params.scale;
+            if (!params.perturbation)
+            {
+                cx[l] -= (T)params.center.x;
+                cy[l] -= (T)params.center.y;
+            }
+
+            if (kernel.iterStart == 0 && params.perturbation && params.seriesSkip > 0)
+            {
+                // position in the view
+                double ux = ((double)px + 0.5 - (double)width / 2) / width;
+                double uy = ((double)y + 0.5 - (double)height / 2) / width;
+                double u2x = ux * ux - uy * uy;
+                double u2y = 2 * ux * uy;
+                double u3x = u2x * ux - u2y * uy;
+                double u3y = u2x * uy + u2y * ux;
+
+                const DVec2& a = params.seriesA;
+                const DVec2& b = params.seriesB;
+                const DVec2& c = params.seriesC;
+                zx[l] = (T)((a.x * ux - a.y * uy) + (b.x * u2x - b.y * u2y) + (c.x * u3x - c.y * u3y));
+                zy[l] = (T)((a.x * uy + a.y * ux) + (b.x * u2y + b.y * u2x) + (c.x * u3y + c.y * u3x));
+                iter[l] = (T)params.seriesSkip;
+                result[l] = 0;
+                ref[l] = (T)(params.seriesSkip + 1);
+            }
+            else if (kernel.iterStart == 0)
+            {
+                zx[l] = cx[l];
+                zy[l] = cy[l];
+                iter[l] = 0;
+                result[l] = 0;
+                // the orbit starts at 0, second point is the center
+                ref[l] = 1;
+
+                // points in the main cardioid and in the period-2 bulb never escape
+                if (params.fractal == GLFractal::Fractal::MANDELBROT && !params.perturbation)
+                {
+                    T xq = cx[l] - (T)0.25;
+                    T y2 = cy[l] * cy[l];
+                    T q = xq * xq + y2;
+                    T xb = cx[l] + 1;
+                    if (q * (q + xq) <= y2 / 4 || xb * xb + y2 <= (T)0.0625)
+                        result[l] = 2;
+                }
+            }
+            else
+            {
+                zx[l] = (T)zState[index * 2];
+                zy[l] = (T)zState[index * 2 + 1];
+                iter[l] = (T)iterState[index * 2];
+                result[l] = (T)iterState[index * 2 + 1];
+                ref[l] = (T)refState[index];
+            }
+        }
+
+        _ComplexPack<P> z{ P::load(zx), P::load(zy) };
+        P it = P::load(iter);
+        P res = P::load(result);
+        P rf = P::load(ref);
+
+        switch (kernel.fractal)
+        {
+        case GLFractal::Fractal::MANDELBROT:
+            if (kernel.perturbation)
+                kernel.perturb(z, _ComplexPack<P>{ P::load(cx), P::load(cy) }, rf, it, res);
+            else
+                kernel.escapeTime(z, _ComplexPack<P>{ P::load(cx), P::load(cy) }, it, res);
+            break;
+        case GLFractal::Fractal::JULIA:
+            kernel.escapeTime(z, kernel.adder, it, res);
+            break;
+        case GLFractal::Fractal::NEWTON:
+            kernel.newton(z, it, res);
+            break;
+        case GLFractal::Fractal::NOVA:
+            kernel.nova(z, it, res);
+            break;
+        default:
+            break;
+        }
+
+        z.x.store(zx);
+        z.y.store(zy);
+        it.store(iter);
+        res.store(result);
+        rf.store(ref);
+
+        for (int l = 0; l < count; l++)
+        {
+            int index = pixels[l];
+            zState[index * 2] = zx[l];
+            zState[index * 2 + 1] = zy[l];
+            iterState[index * 2] = (int)iter[l];
+            iterState[index * 2 + 1] = (int)result[l];
+            refState[index] = (int)ref[l];
+        }
+    }
+
+    // iterates the pixels in groups of the lanes of the pack
+    template<typename P>
+    void _iteratePixels(const CpuFractalParams& params, int iterStart, int iterEnd, int width, int height,
+        const int* pixels, int count, double* zState, int* iterState, int* refState)
+    {
+        const _Kernel<P> kernel(params, iterStart, iterEnd);
+        for (int i = 0; i < count; i += P::lanes)
+        {
+            int group = count - i < P::lanes ? count - i : P::lanes;
+            _iterateGroup(kernel, params, width, height, pixels + i, group, zState, iterState, refState);
+        }
+    }
+
+    // CpuKernel::Iterate of the instruction set the file is compiled with
+    void _iterate(const CpuFractalParams& params, int iterStart, int iterEnd, int width, int height,
+        const int* pixels, int count, double* zState, int* iterState, int* refState)
+    {
+        if (params.useDouble)
+            _iteratePixels<Simd::Double>(params, iterStart, iterEnd, width, height, pixels, count, zState, iterState, refState);
+        else
+            _iteratePixels<Simd::Float>(params, iterStart, iterEnd, width, height, pixels, count, zState, iterState, refState);
+    }
+}
@@ -0,0 +1,403 @@
+#include "CpuRenderer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "CpuKernel.hpp"
+
+using std::min, std::max;
+
+namespace
+{
+    // pixels are iterated in square tiles, one tile is one job for the thread pool
+    const int _TILE_SIZE = 32;
+    // expensive tiles are split in quarters until they reach this size
+    const int _MIN_TILE_SIZE = 8;
+    // tiles more expensive than this multiple of the average cost are split
+    const int _SPLIT_FACTOR = 2;
+    // distance between the pixels sampled for the cost estimate
+    const int _COST_STEP = 4;
+    // subdivided rectangles this small are iterated whole
+    const int _MIN_SUBDIVISION = 4;
+    // final state of pixels that are inside the set
+    const int _INSIDE = -2;
+    // state of pixels that will be iterated further
+    const int _UNFINISHED = -1;
+}
+
+CpuRenderer::CpuRenderer() : _width(0), _height(0), _skippedPixels(0), _slicePixels(0), _iterStart(0), _iterEnd(0), _kernel(&CpuKernel::best()) {}
+
+CpuRenderer::CpuRenderer(int width, int height, int threadCount)
+    : _width(width)
+    , _height(height)
+    , _skippedPixels(0)
+    , _slicePixels(0)
+    , _iterStart(0)
+    , _iterEnd(0)
+    , _kernel(&CpuKernel::best())
+    , _zState((size_t)width * height * 2)
+    , _iterState((size_t)width * height * 2)
+    , _refState((size_t)width * height)
+    , _deferred((size_t)width * height)
+    , _pool(new ThreadPool(threadCount))
+{
+}
+
+void CpuRenderer::iterate(const CpuFractalParams& params, int iterStart, int iterEnd)
+{
+    // new image starts the statistics of the subdivision
+    if (iterStart == 0)
+    {
+        _skippedPixels = 0;
+        _slicePixels = 0;
+    }
+    iterate(params, iterStart, iterEnd, 0, 0, _width, _height);
+}
+
+void CpuRenderer::iterate(const CpuFractalParams& params, int iterStart, int iterEnd, int x, int y, int width, int height)
+{
+    // newton and nova fractals are not defined without roots
+    if ((params.fractal == GLFractal::Fractal::NEWTON || params.fractal == GLFractal::Fractal::NOVA) && params.rootCount == 0)
+        return;
+    if (width <= 0 || height <= 0)
+        return;
+
+    _params = params;
+    _iterStart = iterStart;
+    _iterEnd = iterEnd;
+
+    // new pixels have nothing left from the earlier slices
+    if (iterStart == 0)
+    {
+        for (int row = y; row < y + height; row++)
+            memset(&_deferred[(size_t)row * _width + x], 0, width);
+    }
+
+    _scheduleTiles(_Tile{ x, y, width, height });
+
+    int tileCount = (int)_tiles.size();
+    _tileSkipped.assign(tileCount, 0);
+    _pool->parallelFor(tileCount, [this](int tile) { _iterateTile(_tiles[tile], _tileSkipped[tile]); });
+
+    for (long long skipped : _tileSkipped)
+        _skippedPixels += skipped;
+    _slicePixels += (long long)width * height;
+}
+
+const int* CpuRenderer::iterState()
+{
+    return _iterState.data();
+}
+
+double CpuRenderer::fillRatio()
+{
+    return _slicePixels > 0 ? (double)_skippedPixels / _slicePixels : 0.0;
+}
+
+void CpuRenderer::shift(int dx, int dy)
+{
+    int width = _width - abs(dx);
+    int height = _height - abs(dy);
+    if (width <= 0 || height <= 0)
+        return;
+
+    // rows are moved in the direction of the shift so that no row is overwritten before it is moved
+    auto move = [&](auto& state, int channels) {
+        for (int i = 0; i < height; i++)
+        {
+            int y = dy > 0 ? _height - 1 - i : i;
+            auto* dst = &state[((size_t)y * _width + max(dx, 0)) * channels];
+            auto* src = &state[((size_t)(y - dy) * _width + max(-dx, 0)) * channels];
+            memmove(dst, src, sizeof(*dst) * width * channels);
+        }
+    };
+    move(_zState, 2);
+    move(_iterState, 2);
+    move(_refState, 1);
+    move(_deferred, 1);
+}
+
+void CpuRenderer::resize(int width, int height)
+{
+    if (width == _width && height == _height)
+        return;
+
+    _width = width;
+    _height = height;
+    _zState.assign((size_t)width * height * 2, 0);
+    _iterState.assign((size_t)width * height * 2, 0);
+    _refState.assign((size_t)width * height, 0);
+    _deferred.assign((size_t)width * height, 0);
+}
+
+int CpuRenderer::threadCount()
+{
+    return _pool ? _pool->threadCount() : 0;
+}
+
+const char* CpuRenderer::instructionSet()
+{
+    return CpuKernel::best().instructionSet;
+}
+
+void CpuRenderer::_scheduleTiles(const _Tile& area)
+{
+    vector<_Tile> tiles;
+    vector<long long> costs;
+    long long totalCost = 0;
+    int x1 = area.x + area.width;
+    int y1 = area.y + area.height;
+    for (int y = area.y; y < y1; y += _TILE_SIZE)
+    {
+        for (int x = area.x; x < x1; x += _TILE_SIZE)
+        {
+            _Tile tile{ x, y, min(_TILE_SIZE, x1 - x), min(_TILE_SIZE, y1 - y) };
+            long long cost = _estimateCost(tile);
+            tiles.push_back(tile);
+            costs.push_back(cost);
+            totalCost += cost;
+        }
+    }
+
+    _tiles.clear();
+    long long splitCost = totalCost / (long long)tiles.size() * _SPLIT_FACTOR;
+    for (size_t i = 0; i < tiles.size(); i++)
+        _addTile(tiles[i], costs[i], splitCost);
+
+    // the center of the view is the most interesting part so it is done first,
+    // the threads steal from the end of the queues so the outer tiles are stolen
+    auto distance = [this](const _Tile& tile) {
+        long long dx = 2 * tile.x + tile.width - _width;
+        long long dy = 2 * tile.y + tile.height - _height;
+        return dx * dx + dy * dy;
+    };
+    std::stable_sort(_tiles.begin(), _tiles.end(), [&distance](const _Tile& a, const _Tile& b) {
+        return distance(a) < distance(b);
+    });
+}
+
+void CpuRenderer::_addTile(const _Tile& tile, long long cost, long long splitCost)
+{
+    if (cost <= splitCost || tile.width <= _MIN_TILE_SIZE || tile.height <= _MIN_TILE_SIZE)
+    {
+        _tiles.push_back(tile);
+        return;
+    }
+
+    // splitting into quarters so that expensive part of the image is spread over more threads
+    int w = tile.width / 2;
+    int h = tile.height / 2;
+    _Tile quarters[4]
+    {
+        { tile.x, tile.y, w, h },
+        { tile.x + w, tile.y, tile.width - w, h },
+        { tile.x, tile.y + h, w, tile.height - h },
+        { tile.x + w, tile.y + h, tile.width - w, tile.height - h },
+    };
+    for (const _Tile& quarter : quarters)
+        _addTile(quarter, _estimateCost(quarter), splitCost);
+}
+
+long long CpuRenderer::_estimateCost(const _Tile& tile)
+{
+    // nova does the same number of iterations for every pixel
+    long long slice = _iterEnd - _iterStart;
+    if (_params.fractal == GLFractal::Fractal::NOVA)
+        return slice * tile.width * tile.height;
+
+    // when continuing the image, only the pixels that are not done yet cost something,
+    // new image is predicted from the iterations of the previous image (e.g. before moving the view)
+    long long cost = 0;
+    for (int y = tile.y; y < tile.y + tile.height; y += _COST_STEP)
+    {
+        for (int x = tile.x; x < tile.x + tile.width; x += _COST_STEP)
+        {
+            const int* state = &_iterState[((size_t)y * _width + x) * 2];
+            if (state[1] == 0)
+                cost += slice;
+            else if (_iterStart == 0)
+                cost += min((long long)state[0], slice);
+            // every pixel has some cost even if it is done
+            cost++;
+        }
+    }
+    return cost * _COST_STEP * _COST_STEP;
+}
+
+void CpuRenderer::_iterateTile(const _Tile& tile, long long& skipped)
+{
+    int x0 = tile.x;
+    int y0 = tile.y;
+    int x1 = tile.x + tile.width;
+    int y1 = tile.y + tile.height;
+
+    bool escapeTime = _params.fractal == GLFractal::Fractal::MANDELBROT || _params.fractal == GLFractal::Fractal::JULIA;
+    vector<int> pixels;
+    if (!_params.subdivision || !escapeTime || tile.width <= 2 || tile.height <= 2)
+    {
+        for (int y = y0; y < y1; y++)
+        {
+            pixels.clear();
+            for (int x = x0; x < x1; x++)
+                pixels.push_back(y * _width + x);
+            _iterateCatchingUp(pixels);
+        }
+        return;
+    }
+
+    // border of the tile, the rest is subdivided
+    for (int x = x0; x < x1; x++)
+    {
+        pixels.push_back(y0 * _width + x);
+        pixels.push_back((y1 - 1) * _width + x);
+    }
+    for (int y = y0 + 1; y < y1 - 1; y++)
+    {
+        pixels.push_back(y * _width + x0);
+        pixels.push_back(y * _width + x1 - 1);
+    }
+    _iterateCatchingUp(pixels);
+
+    // all rectangles of one level of the subdivision are iterated together so that the SIMD lanes are filled
+    vector<_Tile> rects{ tile };
+    vector<_Tile> next;
+    while (!rects.empty())
+    {
+        pixels.clear();
+        next.clear();
+        for (const _Tile& rect : rects)
+            _subdivide(rect, pixels, next, skipped);
+        _iterateCatchingUp(pixels);
+        rects.swap(next);
+    }
+}
+
+void CpuRenderer::_iterateCatchingUp(vector<int>& pixels)
+{
+    auto late = std::stable_partition(pixels.begin(), pixels.end(), [this](int index) { return !_deferred[index]; });
+    int current = (int)(late - pixels.begin());
+    _iteratePixels(_iterStart, pixels.data(), current);
+    // pixels deferred in the earlier slices weren't iterated at all yet
+    _iteratePixels(0, pixels.data() + current, (int)pixels.size() - current);
+    for (; late != pixels.end(); ++late)
+        _deferred[*late] = 0;
+}
+
+void CpuRenderer::_iteratePixels(int iterStart, const int* pixels, int count)
+{
+    if (count > 0)
+        _kernel->iterate(_params, iterStart, _iterEnd, _width, _height, pixels, count, _zState.data(), _iterState.data(), _refState.data());
+}
+
+// the border of the rectangle is already iterated, its inside is filled, deferred to the next slice
+// or the pixels that have to be iterated and the smaller rectangles are added to 'pixels' and 'next'
+void CpuRenderer::_subdivide(const _Tile& rect, vector<int>& pixels, vector<_Tile>& next, long long& skipped)
+{
+    int x0 = rect.x;
+    int y0 = rect.y;
+    int x1 = rect.x + rect.width - 1;
+    int y1 = rect.y + rect.height - 1;
+
+    // nothing inside the border
+    if (x1 - x0 < 2 || y1 - y0 < 2)
+        return;
+
+    // the escape time sets are connected, so when the whole border has the same final state the inside has it too
+    int state = _finalState(y0 * _width + x0);
+    bool finished = true;
+    bool uniform = true;
+    auto check = [&](int index) {
+        int pixel = _finalState(index);
+        finished = finished && pixel != _UNFINISHED;
+        uniform = uniform && pixel == state;
+    };
+    for (int x = x0; x <= x1 && finished; x++)
+    {
+        check(y0 * _width + x);
+        check(y1 * _width + x);
+    }
+    for (int y = y0 + 1; y < y1 && finished; y++)
+    {
+        check(y * _width + x0);
+        check(y * _width + x1);
+    }
+
+    // the border isn't done until the last slices (e.g. around the inside of the set),
+    // the inside waits for it and is iterated from the start once it is filled or split
+    if (!finished)
+    {
+        for (int y = y0 + 1; y < y1; y++)
+        {
+            for (int x = x0 + 1; x < x1; x++)
+            {
+                int index = y * _width + x;
+                if (_deferred[index])
+                    continue;
+                _deferred[index] = 1;
+                _iterState[(size_t)index * 2] = 0;
+                _iterState[(size_t)index * 2 + 1] = 0;
+            }
+        }
+        skipped += (long long)(x1 - x0 - 1) * (y1 - y0 - 1);
+        return;
+    }
+
+    if (uniform)
+    {
+        const int* fill = &_iterState[((size_t)y0 * _width + x0) * 2];
+        int iterations = fill[0];
+        int result = state == _INSIDE ? 2 : fill[1];
+        for (int y = y0 + 1; y < y1; y++)
+        {
+            for (int x = x0 + 1; x < x1; x++)
+            {
+                int* pixel = &_iterState[((size_t)y * _width + x) * 2];
+                pixel[0] = iterations;
+                pixel[1] = result;
+                _deferred[(size_t)y * _width + x] = 0;
+            }
+        }
+        skipped += (long long)(x1 - x0 - 1) * (y1 - y0 - 1);
+        return;
+    }
+
+    if (x1 - x0 <= _MIN_SUBDIVISION || y1 - y0 <= _MIN_SUBDIVISION)
+    {
+        for (int y = y0 + 1; y < y1; y++)
+        {
+            for (int x = x0 + 1; x < x1; x++)
+                pixels.push_back(y * _width + x);
+        }
+        return;
+    }
+
+    // splitting the longer side, the line between the halves becomes part of both borders
+    if (x1 - x0 >= y1 - y0)
+    {
+        int xm = (x0 + x1) / 2;
+        for (int y = y0 + 1; y < y1; y++)
+            pixels.push_back(y * _width + xm);
+        next.push_back(_Tile{ x0, y0, xm - x0 + 1, rect.height });
+        next.push_back(_Tile{ xm, y0, x1 - xm + 1, rect.height });
+    }
+    else
+    {
+        int ym = (y0 + y1) / 2;
+        for (int x = x0 + 1; x < x1; x++)
+            pixels.push_back(ym * _width + x);
+        next.push_back(_Tile{ x0, y0, rect.width, ym - y0 + 1 });
+        next.push_back(_Tile{ x0, ym, rect.width, y1 - ym + 1 });
+    }
+}
+
+// iterations of escaped pixels, _INSIDE or _UNFINISHED when the pixel isn't done yet
+int CpuRenderer::_finalState(int index)
+{
+    const int* state = &_iterState[(size_t)index * 2];
+    if (state[1] == 1)
+        return state[0];
+    if (state[1] == 2 || state[0] >= _params.iterations)
+        return _INSIDE;
+    return _UNFINISHED;
+}
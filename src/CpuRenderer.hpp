@@ -0,0 +1,172 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include "GLFractal.hpp"
+#include "Vectors.hpp"
+#include "ThreadPool.hpp"
+
+using std::vector, std::unique_ptr;
+
+struct CpuKernel;
+
+/// <summary>
+/// Parameters of the fractal that is iterated on the CPU (same as the uniforms of the fractal shaders)
+/// </summary>
+struct CpuFractalParams
+{
+    GLFractal::Fractal fractal{ GLFractal::Fractal::MANDELBROT };
+    bool useDouble{ false };
+
+    double scale{ 4.0 };
+    DVec2 center{ 0.0, 0.0 };
+    // iterations of the finished image (iterEnd of the last slice)
+    int iterations{ 0 };
+    // mandelbrot and julia tiles are subdivided and parts with uniform border are filled without iterating them
+    bool subdivision{ false };
+
+    // mandelbrot and julia points whose z comes closer than this to an earlier z are inside the set (0 = no periodicity checking)
+    double periodTolerance{ 0.0 };
+    // julia constant, nova adder
+    DVec2 adder{ 0.0, 0.0 };
+    // nova multiplier
+    DVec2 multiplier{ 1.0, 0.0 };
+
+    int rootCount{ 0 };
+    Vec2 roots[10];
+    int coefCount{ 0 };
+    Vec2 coefs[11];
+
+    // mandelbrot set iterated as differences from the reference orbit at the center,
+    // the orbit starts at 0 and has orbitLength points (x, y)
+    bool perturbation{ false };
+    const double* orbit{ nullptr };
+    int orbitLength{ 0 };
+
+    // iterations skipped by series approximation, dz = A * u + B * u^2 + C * u^3 where u is the position in the view
+    int seriesSkip{ 0 };
+    DVec2 seriesA{ 0.0, 0.0 };
+    DVec2 seriesB{ 0.0, 0.0 };
+    DVec2 seriesC{ 0.0, 0.0 };
+};
+
+/// <summary>
+/// Iterates the fractals on the CPU with SIMD instructions on multiple threads,
+/// the iteration state has the same layout as the state images of the fractal shaders.
+/// The image is split into tiles ordered from the center outwards, tiles that are expected to be expensive are split further.
+/// Mandelbrot and julia tiles can be rendered with Mariani-Silver subdivision, only the borders of rectangles are iterated
+/// and rectangles with uniform border are filled
+/// </summary>
+class CpuRenderer
+{
+public:
+    /// <summary>
+    /// Creates renderer with no image
+    /// </summary>
+    CpuRenderer();
+    /// <summary>
+    /// Creates renderer for image of the given size
+    /// </summary>
+    /// <param name="width">Width of the image in pixels</param>
+    /// <param name="height">Height of the image in pixels</param>
+    /// <param name="threadCount">Number of threads (0 = number of cores)</param>
+    CpuRenderer(int width, int height, int threadCount);
+    /// <summary>
+    /// Does the iterations from iterStart to iterEnd for each pixel (iterStart = 0 starts new image)
+    /// </summary>
+    /// <param name="params">Fractal that is iterated</param>
+    /// <param name="iterStart">Iterations that are already done</param>
+    /// <param name="iterEnd">Iterations done after this call</param>
+    void iterate(const CpuFractalParams& params, int iterStart, int iterEnd);
+    /// <summary>
+    /// Does the iterations from iterStart to iterEnd only for the pixels in the rectangle
+    /// </summary>
+    /// <param name="params">Fractal that is iterated</param>
+    /// <param name="iterStart">Iterations that are already done</param>
+    /// <param name="iterEnd">Iterations done after this call</param>
+    /// <param name="x">Left column of the rectangle</param>
+    /// <param name="y">Bottom row of the rectangle</param>
+    /// <param name="width">Width of the rectangle in pixels</param>
+    /// <param name="height">Height of the rectangle in pixels</param>
+    void iterate(const CpuFractalParams& params, int iterStart, int iterEnd, int x, int y, int width, int height);
+    /// <summary>
+    /// Moves the iteration state of the image, pixels moved out of the image are lost
+    /// and the uncovered pixels have to be iterated again
+    /// </summary>
+    /// <param name="dx">Pixels to move to the right</param>
+    /// <param name="dy">Pixels to move up</param>
+    void shift(int dx, int dy);
+    /// <summary>
+    /// Changes the size of the image, the state is kept only if the size stays the same
+    /// </summary>
+    /// <param name="width">Width of the image in pixels</param>
+    /// <param name="height">Height of the image in pixels</param>
+    void resize(int width, int height);
+    /// <summary>
+    /// Gets the iteration state, two ints for each pixel (iterations, result), rows go from the bottom.
+    /// Result of mandelbrot and julia is 1 for escaped points and 2 for points found to be inside the set
+    /// </summary>
+    /// <returns>Pointer to the state</returns>
+    const int* iterState();
+    /// <summary>
+    /// Gets the part of the pixels that subdivision filled or deferred instead of iterating them, over all slices of the image
+    /// </summary>
+    /// <returns>Skipped pixels / all pixels of the iterate calls since the image was started</returns>
+    double fillRatio();
+    /// <summary>
+    /// Gets the number of threads used for iterating
+    /// </summary>
+    /// <returns>Number of threads</returns>
+    int threadCount();
+    /// <summary>
+    /// Gets the name of the SIMD instruction set that is used (chosen when the program starts)
+    /// </summary>
+    /// <returns>Name of the instruction set</returns>
+    static const char* instructionSet();
+private:
+    struct _Tile
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    void _scheduleTiles(const _Tile& area);
+    void _addTile(const _Tile& tile, long long cost, long long splitCost);
+    long long _estimateCost(const _Tile& tile);
+    void _iterateTile(const _Tile& tile, long long& skipped);
+    void _iteratePixels(int iterStart, const int* pixels, int count);
+    void _iterateCatchingUp(vector<int>& pixels);
+    void _subdivide(const _Tile& rect, vector<int>& pixels, vector<_Tile>& next, long long& skipped);
+    int _finalState(int index);
+
+    int _width;
+    int _height;
+
+    // tiles of the current iterate call in the order they should be started
+    vector<_Tile> _tiles;
+    // number of pixels filled or deferred by subdivision in each tile
+    vector<long long> _tileSkipped;
+    // pixels skipped by subdivision and all pixels of the iterate calls since the image was started
+    long long _skippedPixels;
+    long long _slicePixels;
+
+    CpuFractalParams _params;
+    int _iterStart;
+    int _iterEnd;
+    // iteration code of the widest instruction set the processor supports
+    const CpuKernel* _kernel;
+
+    // z of each pixel (x, y)
+    vector<double> _zState;
+    // iterations and result of each pixel
+    vector<int> _iterState;
+    // index in the reference orbit of each pixel
+    vector<int> _refState;
+    // pixels inside the rectangles whose border wasn't finished, they haven't been iterated since the image was started
+    vector<unsigned char> _deferred;
+
+    unique_ptr<ThreadPool> _pool;
+};
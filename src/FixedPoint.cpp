@@ -0,0 +1,207 @@
+#include "FixedPoint.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+using std::max;
+
+FixedPoint::FixedPoint() : _limbs(1, 0), _negative(false) {}
+
+FixedPoint::FixedPoint(double value) : FixedPoint(value, 0)
+{
+    if (value == 0)
+        return;
+
+    // enough limbs to keep all bits of the mantissa
+    int exponent;
+    std::frexp(value, &exponent);
+    *this = FixedPoint(value, limbsForBits(53 - exponent));
+}
+
+FixedPoint::FixedPoint(double value, int fracLimbs) : _limbs(fracLimbs + 1, 0), _negative(value < 0)
+{
+    if (value == 0)
+        return;
+
+    // value = mantissa * 2^(exponent - 53), the mantissa is shifted into the limbs
+    int exponent;
+    double fraction = std::frexp(std::abs(value), &exponent);
+    uint64_t mantissa = (uint64_t)std::ldexp(fraction, 53);
+    int shift = exponent - 53 + 32 * fracLimbs;
+
+    // bits below the precision are cut off
+    if (shift < 0)
+    {
+        mantissa = shift > -64 ? mantissa >> -shift : 0;
+        shift = 0;
+    }
+
+    int index = shift / 32;
+    int offset = shift % 32;
+    uint32_t parts[3]
+    {
+        (uint32_t)(mantissa << offset),
+        (uint32_t)(offset == 0 ? mantissa >> 32 : mantissa >> (32 - offset)),
+        (uint32_t)(offset == 0 ? 0 : mantissa >> (64 - offset)),
+    };
+    for (int i = 0; i < 3 && index + i < (int)_limbs.size(); i++)
+        _limbs[index + i] = parts[i];
+
+    if (std::all_of(_limbs.begin(), _limbs.end(), [](uint32_t l) { return l == 0; }))
+        _negative = false;
+}
+
+int FixedPoint::fracLimbs() const
+{
+    return (int)_limbs.size() - 1;
+}
+
+FixedPoint FixedPoint::withPrecision(int fracLimbs) const
+{
+    FixedPoint res = *this;
+    int difference = fracLimbs - this->fracLimbs();
+    if (difference > 0)
+        res._limbs.insert(res._limbs.begin(), difference, 0);
+    else if (difference < 0)
+        res._limbs.erase(res._limbs.begin(), res._limbs.begin() - difference);
+
+    if (std::all_of(res._limbs.begin(), res._limbs.end(), [](uint32_t l) { return l == 0; }))
+        res._negative = false;
+    return res;
+}
+
+double FixedPoint::toDouble() const
+{
+    double res = 0;
+    int fl = fracLimbs();
+    for (int i = 0; i < (int)_limbs.size(); i++)
+        res += std::ldexp((double)_limbs[i], 32 * (i - fl));
+    return _negative ? -res : res;
+}
+
+FixedPoint FixedPoint::divide(uint32_t divisor) const
+{
+    FixedPoint res = *this;
+    uint64_t remainder = 0;
+    for (int i = (int)_limbs.size() - 1; i >= 0; i--)
+    {
+        uint64_t current = (remainder << 32) | _limbs[i];
+        res._limbs[i] = (uint32_t)(current / divisor);
+        remainder = current % divisor;
+    }
+
+    if (std::all_of(res._limbs.begin(), res._limbs.end(), [](uint32_t l) { return l == 0; }))
+        res._negative = false;
+    return res;
+}
+
+int FixedPoint::limbsForBits(int bits)
+{
+    return bits <= 0 ? 0 : (bits + 31) / 32;
+}
+
+int FixedPoint::_compareMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b)
+{
+    for (int i = (int)a.size() - 1; i >= 0; i--)
+    {
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+FixedPoint FixedPoint::_addSigned(const FixedPoint& a, const FixedPoint& b, bool negateB)
+{
+    int fl = max(a.fracLimbs(), b.fracLimbs());
+    FixedPoint x = a.withPrecision(fl);
+    FixedPoint y = b.withPrecision(fl);
+    if (negateB)
+        y._negative = !y._negative;
+
+    FixedPoint res;
+    res._limbs.assign(fl + 1, 0);
+
+    if (x._negative == y._negative)
+    {
+        uint64_t carry = 0;
+        for (int i = 0; i <= fl; i++)
+        {
+            uint64_t sum = (uint64_t)x._limbs[i] + y._limbs[i] + carry;
+            res._limbs[i] = (uint32_t)sum;
+            carry = sum >> 32;
+        }
+        res._negative = x._negative;
+    }
+    else
+    {
+        // subtracting the smaller magnitude from the bigger one
+        if (_compareMagnitude(x._limbs, y._limbs) < 0)
+            std::swap(x, y);
+
+        int64_t borrow = 0;
+        for (int i = 0; i <= fl; i++)
+        {
+            int64_t diff = (int64_t)x._limbs[i] - y._limbs[i] - borrow;
+            borrow = diff < 0 ? 1 : 0;
+            res._limbs[i] = (uint32_t)(diff + (borrow << 32));
+        }
+        res._negative = x._negative;
+    }
+
+    if (std::all_of(res._limbs.begin(), res._limbs.end(), [](uint32_t l) { return l == 0; }))
+        res._negative = false;
+    return res;
+}
+
+FixedPoint operator+(const FixedPoint& a, const FixedPoint& b)
+{
+    return FixedPoint::_addSigned(a, b, false);
+}
+
+FixedPoint operator-(const FixedPoint& a, const FixedPoint& b)
+{
+    return FixedPoint::_addSigned(a, b, true);
+}
+
+FixedPoint operator*(const FixedPoint& a, const FixedPoint& b)
+{
+    int fa = a.fracLimbs();
+    int fb = b.fracLimbs();
+    int fl = max(fa, fb);
+
+    // full product has fa + fb fractional limbs, the lowest ones are cut off
+    vector<uint32_t> product(a._limbs.size() + b._limbs.size(), 0);
+    for (size_t i = 0; i < a._limbs.size(); i++)
+    {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < b._limbs.size(); j++)
+        {
+            uint64_t t = (uint64_t)a._limbs[i] * b._limbs[j] + product[i + j] + carry;
+            product[i + j] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        product[i + b._limbs.size()] = (uint32_t)carry;
+    }
+
+    FixedPoint res;
+    int cut = fa + fb - fl;
+    res._limbs.assign(product.begin() + cut, product.begin() + cut + fl + 1);
+    res._negative = a._negative != b._negative;
+
+    if (std::all_of(res._limbs.begin(), res._limbs.end(), [](uint32_t l) { return l == 0; }))
+        res._negative = false;
+    return res;
+}
+
+FixedPoint operator-(const FixedPoint& a)
+{
+    FixedPoint res = a;
+    if (std::any_of(res._limbs.begin(), res._limbs.end(), [](uint32_t l) { return l != 0; }))
+        res._negative = !res._negative;
+    return res;
+}
+
+bool operator==(const FixedPoint& a, const FixedPoint& b)
+{
+    return a._negative == b._negative && a._limbs == b._limbs;
+}
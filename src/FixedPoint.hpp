@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+using std::vector;
+
+/// <summary>
+/// Signed fixed point number with any number of fractional bits, used where double doesn't have enough precision (deep zoom).
+/// The integer part has 32 bits
+/// </summary>
+class FixedPoint
+{
+public:
+    /// <summary>
+    /// Initializes 0 with no fractional bits
+    /// </summary>
+    FixedPoint();
+    /// <summary>
+    /// Initializes number with exactly the same value as the double
+    /// </summary>
+    /// <param name="value">Value of the number (must be less than 2^32)</param>
+    FixedPoint(double value);
+    /// <summary>
+    /// Initializes number from double, the bits that don't fit are cut off
+    /// </summary>
+    /// <param name="value">Value of the number (must be less than 2^32)</param>
+    /// <param name="fracLimbs">Number of fractional 32 bit limbs</param>
+    FixedPoint(double value, int fracLimbs);
+
+    /// <summary>
+    /// Gets the number of fractional 32 bit limbs
+    /// </summary>
+    /// <returns>Number of limbs</returns>
+    int fracLimbs() const;
+    /// <summary>
+    /// Creates copy with different precision, the bits that don't fit are cut off
+    /// </summary>
+    /// <param name="fracLimbs">Number of fractional 32 bit limbs</param>
+    /// <returns>Number with the given precision</returns>
+    FixedPoint withPrecision(int fracLimbs) const;
+    /// <summary>
+    /// Converts the number to the nearest lower double
+    /// </summary>
+    /// <returns>Value as double</returns>
+    double toDouble() const;
+    /// <summary>
+    /// Divides the number by small integer, the bits that don't fit are cut off
+    /// </summary>
+    /// <param name="divisor">Number to divide by</param>
+    /// <returns>Result of the division</returns>
+    FixedPoint divide(uint32_t divisor) const;
+
+    /// <summary>
+    /// Gets the number of fractional limbs needed for the given number of fractional bits
+    /// </summary>
+    /// <param name="bits">Number of fractional bits</param>
+    /// <returns>Number of limbs</returns>
+    static int limbsForBits(int bits);
+
+    // results of the operations have the precision of the more precise operand
+    friend FixedPoint operator+(const FixedPoint& a, const FixedPoint& b);
+    friend FixedPoint operator-(const FixedPoint& a, const FixedPoint& b);
+    friend FixedPoint operator*(const FixedPoint& a, const FixedPoint& b);
+    friend FixedPoint operator-(const FixedPoint& a);
+    friend bool operator==(const FixedPoint& a, const FixedPoint& b);
+private:
+    static int _compareMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b);
+    static FixedPoint _addSigned(const FixedPoint& a, const FixedPoint& b, bool negateB);
+
+    // magnitude in little endian, the last limb is the integer part
+    vector<uint32_t> _limbs;
+    bool _negative;
+};
@@ -0,0 +1,65 @@
+#include "FramePacer.hpp"
+
+#include <chrono>
+#include <algorithm>
+
+using std::max;
+
+FramePacer::FramePacer() : FramePacer(0, 0) {}
+
+FramePacer::FramePacer(double fpsLimit, double inputRate)
+    : _targetFrameTime(fpsLimit > 0 ? 1.0 / fpsLimit : 0)
+    , _inputInterval(inputRate > 0 ? 1.0 / inputRate : 0)
+    , _deadline(0)
+    , _frameStart(0)
+    , _frameTime(0)
+{
+}
+
+double FramePacer::timeToFrame()
+{
+    return max(_deadline - _now(), 0.0);
+}
+
+double FramePacer::inputInterval()
+{
+    return _inputInterval;
+}
+
+void FramePacer::beginFrame()
+{
+    _frameStart = _now();
+
+    // the deadline moves by whole frames so that the frame rate doesn't drift,
+    // but when the frames are late (or the loop was idle) it starts over from now
+    _deadline += _targetFrameTime;
+    if (_deadline < _frameStart)
+        _deadline = _frameStart + _targetFrameTime;
+}
+
+void FramePacer::endFrame()
+{
+    _frameTime = _now() - _frameStart;
+}
+
+double FramePacer::frameTime()
+{
+    return _frameTime;
+}
+
+double FramePacer::targetFrameTime()
+{
+    return _targetFrameTime;
+}
+
+double FramePacer::fps()
+{
+    double time = max(_frameTime, _targetFrameTime);
+    return time > 0 ? 1.0 / time : 0;
+}
+
+double FramePacer::_now()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
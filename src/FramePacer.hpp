@@ -0,0 +1,61 @@
+#pragma once
+
+/// <summary>
+/// Decides when the next frame should be rendered and measures how long the frames take
+/// </summary>
+class FramePacer
+{
+public:
+    /// <summary>
+    /// Creates pacer with no fps limit
+    /// </summary>
+    FramePacer();
+    /// <summary>
+    /// Creates pacer for the given fps limit
+    /// </summary>
+    /// <param name="fpsLimit">Maximum number of frames per second</param>
+    /// <param name="inputRate">How many times per second should the input be sampled while waiting for a frame</param>
+    FramePacer(double fpsLimit, double inputRate);
+    /// <summary>
+    /// Gets the time remaining until the deadline of the next frame
+    /// </summary>
+    /// <returns>Time in seconds, 0 if the frame can be rendered now</returns>
+    double timeToFrame();
+    /// <summary>
+    /// Gets the longest time that can be slept before the input has to be sampled again
+    /// </summary>
+    /// <returns>Time in seconds</returns>
+    double inputInterval();
+    /// <summary>
+    /// Marks the start of a frame and moves the deadline of the next frame
+    /// </summary>
+    void beginFrame();
+    /// <summary>
+    /// Marks the end of a frame (after the buffers were swapped)
+    /// </summary>
+    void endFrame();
+    /// <summary>
+    /// Gets how long it took to render the last frame
+    /// </summary>
+    /// <returns>Time in seconds</returns>
+    double frameTime();
+    /// <summary>
+    /// Gets the time that one frame should take with the fps limit
+    /// </summary>
+    /// <returns>Time in seconds</returns>
+    double targetFrameTime();
+    /// <summary>
+    /// Gets the number of frames per second that can be achieved with the last frame time
+    /// </summary>
+    /// <returns>Frames per second</returns>
+    double fps();
+private:
+    double _now();
+
+    double _targetFrameTime;
+    double _inputInterval;
+
+    double _deadline;
+    double _frameStart;
+    double _frameTime;
+};
@@ -5,6 +5,10 @@
 
 #include <cmath>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
 
 #include "Shader.hpp"
 #include "FontTexture.hpp"
@@ -12,6 +16,12 @@
 #include "Complex.hpp"
 #include "Gradient.hpp"
 #include "Parser.hpp"
+#include "FramePacer.hpp"
+#include "ViewCache.hpp"
+#include "GpuTimer.hpp"
+#include "Tracer.hpp"
+#include "CpuRenderer.hpp"
+#include "FixedPoint.hpp"
 
 namespace GLFractal
 {
@@ -21,6 +31,7 @@ namespace GLFractal
 
         enum class _Fractal;
         enum class _RenderChange;
+        enum class _GpuPass;
 
 
         //==================================<<CONSTANTS>>==================================//
@@ -42,8 +53,38 @@ namespace GLFractal
         const int _MAX_ROOTS = 10;
         const int _MAX_CONSTANTS = 10;
 
-        // when rendering text, determines how many characters will be rendered at once
-        const int _MAX_STR_LEN = 64;
+        // glyphs the text buffer holds for one frame at first, it grows when a frame has more
+        const int _TEXT_GLYPHS = 1024;
+        // frames the text buffer has regions for, the gpu may still draw the text of the previous frames
+        const int _TEXT_REGIONS = 3;
+        // laid out lines that weren't drawn in this many batches are dropped from the cache
+        const int _TEXT_CACHE_AGE = 120;
+
+        // below these scales the mandelbrot set is rendered with perturbation from a reference orbit
+        const double _PERTURBATION_SCALE_F = 1e-3;
+        const double _PERTURBATION_SCALE_DF = 1e-9;
+        const double _PERTURBATION_SCALE_D = 1e-11;
+        // below this scale float can't hold the distances between pixels so double is used for perturbation
+        const double _MIN_FLOAT_DELTA_SCALE = 1e-30;
+        // smallest distance between pixels relative to the coordinates that float and df64 still resolve,
+        // sixteen units in the last place leave room for the rounding errors of the iterations
+        const double _FLOAT_RESOLUTION = 16.0 / (1 << 24);
+        const double _DF64_RESOLUTION = 16.0 / (1ll << 44);
+        // periodicity checking needs a few units in the last place of z even when pixels are closer than that
+        const double _PERIOD_FLOOR_F = 4.0 / (1 << 23);
+        const double _PERIOD_FLOOR_DF = 4.0 / (1ll << 46);
+        const double _PERIOD_FLOOR_D = 4.0 / (1ll << 52);
+        // largest error of the series approximation relative to the distance between pixels
+        const double _SERIES_TOLERANCE = 1e-3;
+        // the changing main view is rendered with at least 1 / 8 of the pixels in each direction
+        const int _MAX_REDUCTION = 8;
+        // side of the tiles the compute shaders iterate, same as the local size in tiles.comp
+        const int _TILE_SIZE = 8;
+        // events kept by the tracer, the last few hundred frames
+        const int _TRACE_EVENTS = 1 << 16;
+        // offsets of the antialiasing samples follow the R2 sequence, which covers a pixel evenly for any number of samples
+        const double _R2_X = 0.7548776662466927;
+        const double _R2_Y = 0.5698402909980532;
 
 
         //==================================<<VARIABLES>>==================================//
@@ -52,6 +93,9 @@ namespace GLFractal
 
         double _scale;
         DVec2  _center;
+        // center of the main view with as many bits as needed to get to it, _center is the closest double
+        FixedPoint _deepCenterX;
+        FixedPoint _deepCenterY;
         int    _iterations;
         Vec3   _color;
         DVec2  _constants[_MAX_CONSTANTS];
@@ -64,17 +108,100 @@ namespace GLFractal
         float _selColorCount;
 
         Fractal _frac;
-        bool    _useDouble;
+        Precision _precision;
+        // help fractal shows the debug page instead of the key bindings (F3)
+        bool      _debugPage = false;
+        // relative to the distance between pixels
+        double _periodicityTolerance;
+
+        Backend     _backend;
+        CpuRenderer _cpu;
+        bool        _subdivision;
+
+        // finished images of the main view, revisited views are copied instead of iterated again
+        ViewCache _cache;
+        // the image being rendered is stored in the cache once it is finished in full resolution
+        bool      _cachePending = false;
 
         GLFWwindow* _window;
 
+        // size of the main view (the window layout is used unless rendering headless)
+        int _mainWidth = _VIEW_WIDTH;
+        int _mainHeight = _VIEW_HEIGHT;
+
         FontTexture _font;
         int         _fontSize;
         Shader      _fontShader;
         Vec3        _textColor;
         Mat4        _fontProjection;
 
-        double _fpsLimit;
+        // glyph quads are written into the mapped vertex buffer and drawn at once by _flushText
+        struct
+        {
+            // persistently mapped regions of the vertex buffer, 16 floats for each glyph
+            float* vertices = nullptr;
+            // glyphs of one region, the index buffer has quads for all of them
+            int    capacity = 0;
+            int    region = 0;
+            // glyphs written into the region since the last flush
+            int    count = 0;
+            // signaled when the gpu has drawn the text of the region
+            GLsync fences[_TEXT_REGIONS]{};
+        } _text;
+
+        // line of text at its position, laid out lines are reused while the line stays the same
+        struct _TextKey
+        {
+            string text;
+            float  x;
+            float  y;
+            float  scale;
+
+            bool operator==(const _TextKey&) const = default;
+        };
+
+        struct _TextKeyHash
+        {
+            size_t operator()(const _TextKey& key) const
+            {
+                size_t hash = std::hash<string>()(key.text);
+                for (float value : { key.x, key.y, key.scale })
+                    hash = hash * 31 + std::hash<float>()(value);
+                return hash;
+            }
+        };
+
+        struct _TextLayout
+        {
+            // glyph quads in the format of the text buffer
+            vector<float> vertices;
+            // batch the line was last drawn in
+            int used;
+        };
+
+        struct
+        {
+            unordered_map<_TextKey, _TextLayout, _TextKeyHash> lines;
+            // number of batches drawn so far
+            int batch = 0;
+        } _textCache;
+
+        // text kept in its own buffer, it is drawn again without laying it out or uploading it
+        struct _RetainedText
+        {
+            unsigned int vbo = 0;
+            int          count = 0;
+        };
+
+        // help page doesn't change, so it is laid out only once
+        _RetainedText _helpText;
+
+        FramePacer _pacer;
+        // gpu time of the passes in _GpuPass, written to the file when the program ends (empty path doesn't write them)
+        GpuTimer _gpuTimer;
+        string   _gpuTimesPath;
+        // timeline of the frames is written to the file when the program ends (empty path doesn't record it)
+        string   _tracePath;
 
         const struct
         {
@@ -112,17 +239,87 @@ namespace GLFractal
         {
             Shader mandelbrotF;
             Shader mandelbrotD;
+            Shader mandelbrotDF;
+            Shader perturbationF;
+            Shader perturbationD;
             Shader mandelbrotSelector;
             Shader juliaF;
             Shader juliaD;
+            Shader juliaDF;
             Shader newtonCoefF;
             Shader newtonCoefD;
+            Shader newtonCoefDF;
             Shader novaF;
             Shader novaD;
+            Shader novaDF;
+            Shader colorize;
+            Shader edges;
+            Shader antialias;
             Shader selector;
+            Shader markers;
             Shader debug;
         } _fractals;
 
+        // handles of the uniforms set by the update functions, resolved once for all shaders
+        // (the compute kernels run the updates of the fragment shaders with the same handles)
+        const struct
+        {
+            Shader::Uniform scale = Shader::getUniform("scale");
+            Shader::Uniform center = Shader::getUniform("center");
+            Shader::Uniform iterStart = Shader::getUniform("iterStart");
+            Shader::Uniform iterEnd = Shader::getUniform("iterEnd");
+            Shader::Uniform periodTolerance = Shader::getUniform("periodTolerance");
+            Shader::Uniform constant = Shader::getUniform("constant");
+            Shader::Uniform adder = Shader::getUniform("adder");
+            Shader::Uniform multiplier = Shader::getUniform("multiplier");
+
+            Shader::Uniform orbitLength = Shader::getUniform("orbitLength");
+            Shader::Uniform seriesA = Shader::getUniform("seriesA");
+            Shader::Uniform seriesB = Shader::getUniform("seriesB");
+            Shader::Uniform seriesC = Shader::getUniform("seriesC");
+            Shader::Uniform seriesSkip = Shader::getUniform("seriesSkip");
+
+            Shader::Uniform texture1 = Shader::getUniform("texture1");
+            Shader::Uniform iter = Shader::getUniform("iter");
+            Shader::Uniform color = Shader::getUniform("color");
+            Shader::Uniform colorCount = Shader::getUniform("colorCount");
+            Shader::Uniform mode = Shader::getUniform("mode");
+            Shader::Uniform preview = Shader::getUniform("preview");
+            Shader::Uniform usePreview = Shader::getUniform("usePreview");
+            Shader::Uniform renderSize = Shader::getUniform("renderSize");
+            Shader::Uniform previewRatio = Shader::getUniform("previewRatio");
+            Shader::Uniform previewOffset = Shader::getUniform("previewOffset");
+            Shader::Uniform samples = Shader::getUniform("samples");
+            Shader::Uniform sampleCount = Shader::getUniform("sampleCount");
+            Shader::Uniform markerCount = Shader::getUniform("markerCount");
+            Shader::Uniform gradient = Shader::getUniform("gradient");
+
+            Shader::Uniform aspect = Shader::getUniform("aspect");
+            Shader::Uniform boundsMin = Shader::getUniform("boundsMin");
+            Shader::Uniform boundsMax = Shader::getUniform("boundsMax");
+            Shader::Uniform resultFinishes = Shader::getUniform("resultFinishes");
+
+            Shader::Uniform projection = Shader::getUniform("projection");
+            Shader::Uniform textColor = Shader::getUniform("textColor");
+            Shader::Uniform font = Shader::getUniform("font");
+        } _uniforms;
+
+        // Main view is iterated by compute versions of the iteration shaders in tiles of _TILE_SIZE pixels,
+        // each slice dispatches only the tiles that had unfinished pixels after the previous one
+        struct
+        {
+            bool enabled = false;
+            // compute versions of the iteration shaders by the fragment shader they are made from
+            unordered_map<Shader*, Shader> kernels;
+            // tiles of the next dispatch and the tiles that dispatch lists as unfinished (count, 1, 1, tiles)
+            unsigned int current;
+            unsigned int next;
+            // the current tiles are all the unfinished tiles of the whole image
+            bool listed = false;
+            // pixels iterated by the next dispatch (x, y, width, height)
+            int bounds[4] = { 0, 0, 0, 0 };
+        } _tiles;
+
         struct
         {
             unsigned int mainVAO;
@@ -137,19 +334,160 @@ namespace GLFractal
             unsigned int textVBO;
             unsigned int textEBO;
 
+            unsigned int parameterUBO;
+            unsigned int samplingUBO;
+
             unsigned int gradientTexture;
             unsigned int fontTexture;
         } _buffers;
 
-        // Points on screen used to form triangles for main view
-        const float _mainVertices[] =
+        // Contents of the 'Parameters' uniform block shared by the shaders (std140 layout)
+        struct _Parameters
+        {
+            float roots[_MAX_ROOTS][4];
+            float coefs[_MAX_ROOTS + 1][4];
+            float constants[_MAX_CONSTANTS][4];
+            int rootCount;
+            int coefCount;
+            int constantCount;
+        };
+
+        // last parameters sent to the uniform buffer
+        _Parameters _parameters;
+
+        // Framebuffer that keeps the last rendered image of a view so that it
+        // can be composited again without recomputing the fractal
+        struct _RetainedView
         {
-            -1.0f,             1.0f, 0.0f,		1.0f, 0.0f,
-            _NORM_VIEW_WIDTH,  1.0f, 0.0f,		1.0f, 1.0f,
-            _NORM_VIEW_WIDTH, -1.0f, 0.0f,		0.0f, 1.0f,
-            -1.0f,            -1.0f, 0.0f,		0.0f, 0.0f
+            unsigned int fbo;
+            unsigned int texture;
+
+            // position and size of the view in the window (in pixels)
+            int x;
+            int y;
+            int width;
+            int height;
+
+            // part of the framebuffer (from the bottom left) that holds the image,
+            // it is smaller than the view when the view is rendered at lower resolution
+            int imageWidth;
+            int imageHeight;
         };
 
+        struct
+        {
+            _RetainedView main;
+            _RetainedView selector;
+        } _views;
+
+        // views that have to be rendered again before the next frame is shown
+        _RenderChange _dirty;
+
+        // Main view is iterated over multiple frames, the state of each pixel
+        // is kept in images between the frames
+        struct
+        {
+            unsigned int zState;
+            unsigned int iterState;
+            // index in the reference orbit when rendering with perturbation
+            unsigned int refState;
+
+            // how many iterations are done in one frame (0 = all at once)
+            int slice;
+            // iterations that are already done for each pixel
+            int start;
+            // iterations done after the current frame
+            int end;
+            // iterations needed to finish the view
+            int total;
+
+            // when the view is moved, the state is copied into these images and swapped with the ones above
+            // (copied regions of one image can't overlap)
+            unsigned int zSpare;
+            unsigned int iterSpare;
+            unsigned int refSpare;
+            // pixels the view has moved by since the last frame (rows of the images go from the bottom)
+            IVec2 shift;
+        } _progress;
+
+        // Orbit of the center of the main view computed in high precision, pixels of
+        // deep zooms are iterated as small differences from it (perturbation)
+        struct
+        {
+            // points of the orbit (x, y), the first point is 0 and the second is the center
+            vector<double> points;
+
+            // what the orbit was computed for
+            FixedPoint x;
+            FixedPoint y;
+            int iterations = -1;
+
+            // iterations skipped by series approximation and its coefficients (see mandelbrot_perturbation_*.frag)
+            int   skip = 0;
+            DVec2 seriesA;
+            DVec2 seriesB;
+            DVec2 seriesC;
+
+            unsigned int bufferF;
+            unsigned int bufferD;
+        } _orbit;
+
+        // Last finished image of the main view, after the view is moved or zoomed it is shown
+        // moved and scaled in place of the pixels that are not iterated to the end yet
+        struct
+        {
+            unsigned int texture;
+            unsigned int fbo;
+
+            // view the image was rendered with
+            double scale;
+            FixedPoint centerX;
+            FixedPoint centerY;
+
+            // the image shows the current fractal with the current parameters
+            bool valid = false;
+        } _preview;
+
+        // Main view is rendered at lower resolution while it keeps changing so that the frames
+        // stay fast, it is rendered again in full resolution once the input settles
+        struct
+        {
+            // the main view is rendered with 1 / reduction of the pixels in each direction
+            int reduction = 1;
+            // reduction of the next render while the view is changing, adjusted by the frame time
+            int adaptive = 1;
+            // frame time kept while the view is changing (0 = always full resolution)
+            double targetFrameTime = 0;
+            // time without changes after which the view is rendered in full resolution
+            double idleTime = 0;
+            // when the input last changed the main view (the views before the first input aren't interactive)
+            double lastChange = -numeric_limits<double>::infinity();
+        } _resolution;
+
+        // Pixels of the finished main view whose neighbors have very different colors are rendered again as
+        // the average of several samples moved by less than a pixel, one slice of one sample in each frame
+        struct
+        {
+            // samples of each marked pixel (1 = no antialiasing)
+            int samples = 1;
+            // samples that are already added up
+            int sample = 0;
+            // iterations of the current sample that are done, its state is kept in the spare images of _progress
+            int start = 0;
+            // the pixels of the current image are marked
+            bool marked = false;
+            // part of the pixels that are marked
+            double refined = 0;
+
+            // sum of the colors of the samples
+            unsigned int texture;
+            unsigned int fbo;
+            // marked pixels are 1, the buffer is attached to the main view too
+            unsigned int stencil;
+            // number of the marked pixels
+            unsigned int counter;
+        } _antialias;
+
         // Points on screen used to form truengles for point selector view
         const float _selectorVertices[] =
         {
@@ -170,19 +508,40 @@ namespace GLFractal
         //==================================<<HEADERS>>==================================//
 
         inline _RenderChange operator|(_RenderChange rc1, _RenderChange rc2);
+        inline _RenderChange operator&(_RenderChange rc1, _RenderChange rc2);
+        inline _RenderChange& operator|=(_RenderChange& rc1, _RenderChange rc2);
+        void _invalidate(_RenderChange change);
+        bool _interacting();
+        void _adaptResolution(double frameTime);
 
         _Fractal _fractal();
+        Precision _activePrecision();
+        bool _usePerturbation();
+        double _periodTolerance();
+        bool _perturbationDouble();
+        void _resetCenter();
+        void _updateOrbit();
+        void _updateSeries();
 
         void _updateCoefs();
+        void _updateParameters();
 
         GLFResult _init();
         GLFResult _initShaders();
         GLFResult _initBuffers();
+        GLFResult _initViews();
+        GLFResult _createView(_RetainedView& view, int x, int y, int width, int height);
+        GLFResult _initProgress();
+        GLFResult _initTiles();
+        void _createStateImages(unsigned int& zState, unsigned int& iterState, unsigned int& refState);
         GLFResult _loadTexture(GradientPreset gradient);
         GLFResult _loadFont(string fontPath);
+        bool _createTextBuffers(int capacity);
+        vector<float> _layoutText(const string& text, float x, float y, float scale);
 
         void _processInput(GLFWwindow* window);
-        _RenderChange _toggleFloatDouble(GLFWwindow* window);
+        _RenderChange _cyclePrecision(GLFWwindow* window);
+        _RenderChange _cycleAntialiasing(GLFWwindow* window);
         _RenderChange _changeColorCount(GLFWwindow* window, bool allowSelector);
         _RenderChange _changeIterations(GLFWwindow* window, bool allowSelector);
         _RenderChange _changeFractal(GLFWwindow* window);
@@ -192,15 +551,43 @@ namespace GLFractal
         _RenderChange _changeCoefs(GLFWwindow* window);
 
         void _mouseMoveCallback(GLFWwindow* window, double x, double y);
+        void _windowRefreshCallback(GLFWwindow* window);
         _RenderChange _moveConstant(GLFWwindow* window);
         _RenderChange _moveConstants(GLFWwindow* window);
         _RenderChange _moveRoot(GLFWwindow* window);
         _RenderChange _moveView(GLFWwindow* window, DVec2 mouseDelta, bool allowSelector);
         _RenderChange _scaleView(GLFWwindow* window, DVec2 mouseDelta, bool allowSelector);
 
-        void _renderText(string text, float x, float y, float scale);
-
-        void _renderInfo(int fps);
+        GLFResult _renderMain();
+        GLFResult _iterateMain(bool perturbation, bool tiled);
+        void _listTiles(int x, int y, int width, int height);
+        void _dispatchTiles(Shader& shader);
+        GLFResult _shiftMain(bool perturbation);
+        GLFResult _renderMainCpu();
+        void _setResolution(int reduction);
+        CpuFractalParams _cpuParams();
+        void _colorizeMain();
+        ViewKey _viewKey();
+        bool _antialiasPending();
+        GLFResult _antialiasMain();
+        void _setJitter(float x, float y);
+        GLFResult _renderSelector();
+        void _presentView(const _RetainedView& view);
+        void _blitImage(const _RetainedView& view, unsigned int fbo, int x, int y);
+        void _draw(const char* name, int count = 6);
+        void _composite();
+        GLFResult _saveView(const _RetainedView& view, string path);
+        GLFResult _saveMeasurements();
+
+        void _renderText(const string& text, float x, float y, float scale);
+        void _flushText();
+        void _retainText(_RetainedText& text);
+        void _drawText(unsigned int vbo, int count, int baseVertex);
+        void _endTextBatch();
+
+        void _renderInfo();
+        string _iterationsInfo(int iterations);
+        string _antialiasInfo();
 
         void _renderHelp();
 
@@ -215,16 +602,18 @@ namespace GLFractal
             NEWTON = 0b11,
             NOVA = 0b100,
 
-            HELP_F = 0b00,
-            HELP_D = 0b01,
-            MANDELBROT_F = 0b10,
-            MANDELBROT_D = 0b11,
-            JULIA_F = 0b100,
-            JULIA_D = 0b101,
-            NEWTON_F = 0b110,
-            NEWTON_D = 0b111,
-            NOVA_F = 0b1000,
-            NOVA_D = 0b1001,
+            MANDELBROT_F = 0b100,
+            MANDELBROT_D = 0b101,
+            MANDELBROT_DF = 0b110,
+            JULIA_F = 0b1000,
+            JULIA_D = 0b1001,
+            JULIA_DF = 0b1010,
+            NEWTON_F = 0b1100,
+            NEWTON_D = 0b1101,
+            NEWTON_DF = 0b1110,
+            NOVA_F = 0b10000,
+            NOVA_D = 0b10001,
+            NOVA_DF = 0b10010,
         };
 
         enum class _RenderChange
@@ -233,6 +622,26 @@ namespace GLFractal
             NONE = 0,
             MAIN = 0b10,
             SELECTOR = 0b100,
+            // the retained views are up to date, only the window has to be composited again
+            OVERLAY = 0b1000,
+            // the iterations of the main view are up to date, only its colors have changed
+            COLOR = 0b10000,
+            // main view has moved by whole pixels, the iterations of the pixels that stay in view are kept
+            SHIFT = 0b100000,
+            // main view has only moved or zoomed, so the last finished image can stand in for the new one
+            PREVIEW = 0b1000000,
+            // main view is finished, the next slice of the samples of its edges is rendered
+            ANTIALIAS = 0b10000000,
+        };
+
+        // render passes measured by the gpu timer
+        enum class _GpuPass
+        {
+            // iterating, coloring and antialiasing of the main view
+            MAIN = 0,
+            SELECTOR,
+            // info panel
+            TEXT,
         };
 
 
@@ -243,9 +652,217 @@ namespace GLFractal
             return static_cast<_RenderChange>(static_cast<int>(rc1) | static_cast<int>(rc2));
         }
 
+        inline _RenderChange operator&(_RenderChange rc1, _RenderChange rc2)
+        {
+            return static_cast<_RenderChange>(static_cast<int>(rc1) & static_cast<int>(rc2));
+        }
+
+        inline _RenderChange& operator|=(_RenderChange& rc1, _RenderChange rc2)
+        {
+            return rc1 = rc1 | rc2;
+        }
+
+        void _invalidate(_RenderChange change)
+        {
+            // INVALID only means that the input was consumed
+            _dirty |= change & (_RenderChange::MAIN | _RenderChange::SELECTOR | _RenderChange::OVERLAY | _RenderChange::COLOR | _RenderChange::SHIFT);
+
+            // main view has to be iterated again from the start
+            if ((change & _RenderChange::MAIN) != _RenderChange::NONE)
+            {
+                _progress.start = 0;
+                _progress.shift = IVec2(0, 0);
+                if ((change & _RenderChange::PREVIEW) == _RenderChange::NONE)
+                    _preview.valid = false;
+            }
+            if ((change & (_RenderChange::MAIN | _RenderChange::SHIFT)) != _RenderChange::NONE)
+                _resolution.lastChange = glfwGetTime();
+        }
+
+        // the input has changed the main view recently
+        bool _interacting()
+        {
+            return glfwGetTime() - _resolution.lastChange < _resolution.idleTime;
+        }
+
+        // changes the resolution of the next renders of the changing view so that its frames take the target frame time
+        void _adaptResolution(double frameTime)
+        {
+            if (_resolution.targetFrameTime <= 0)
+                return;
+
+            // twice the resolution has four times more pixels, so it is only used when that still fits into the frame
+            if (frameTime > _resolution.targetFrameTime && _resolution.adaptive < _MAX_REDUCTION)
+                _resolution.adaptive *= 2;
+            else if (frameTime * 4 < _resolution.targetFrameTime && _resolution.adaptive > 1)
+                _resolution.adaptive /= 2;
+        }
+
         _Fractal _fractal()
         {
-            return (_Fractal)(((unsigned int)_frac << 1) | (unsigned int)_useDouble);
+            return (_Fractal)(((unsigned int)_frac << 2) | (unsigned int)_activePrecision());
+        }
+
+        Precision _activePrecision()
+        {
+            if (_precision != Precision::AUTO)
+                return _precision;
+
+            // help page isn't iterated
+            if (_frac == Fractal::HELP)
+                return Precision::FLOAT;
+
+            // deep mandelbrot zooms are rendered with float perturbation, which is cheaper than any of the others
+            if (_frac == Fractal::MANDELBROT)
+                return Precision::FLOAT;
+
+            double pixel = _scale / max(_mainWidth, _mainHeight);
+            double magnitude = max(abs(_center.x), abs(_center.y)) + _scale;
+            if (pixel >= magnitude * _FLOAT_RESOLUTION)
+                return Precision::FLOAT;
+            if (pixel >= magnitude * _DF64_RESOLUTION)
+                return Precision::DF64;
+            return Precision::DOUBLE;
+        }
+
+        double _periodTolerance()
+        {
+            if (_periodicityTolerance <= 0)
+                return 0;
+
+            Precision precision = _activePrecision();
+            double floor = precision == Precision::DOUBLE ? _PERIOD_FLOOR_D
+                : precision == Precision::DF64 ? _PERIOD_FLOOR_DF
+                : _PERIOD_FLOOR_F;
+            return max(_periodicityTolerance * _scale / max(_mainWidth, _mainHeight), floor);
+        }
+
+        bool _usePerturbation()
+        {
+            Precision precision = _activePrecision();
+            double limit = precision == Precision::DOUBLE ? _PERTURBATION_SCALE_D
+                : precision == Precision::DF64 ? _PERTURBATION_SCALE_DF
+                : _PERTURBATION_SCALE_F;
+            return _frac == Fractal::MANDELBROT && _scale < limit;
+        }
+
+        bool _perturbationDouble()
+        {
+            return _activePrecision() == Precision::DOUBLE || _scale < _MIN_FLOAT_DELTA_SCALE;
+        }
+
+        void _resetCenter()
+        {
+            if (_initialSettings.preciseCenter)
+            {
+                _deepCenterX = _initialSettings.preciseCenterX;
+                _deepCenterY = _initialSettings.preciseCenterY;
+            }
+            else
+            {
+                _deepCenterX = FixedPoint(_initialSettings.center.x);
+                _deepCenterY = FixedPoint(_initialSettings.center.y);
+            }
+            _center = DVec2(_deepCenterX.toDouble(), _deepCenterY.toDouble());
+        }
+
+        void _updateOrbit()
+        {
+            // enough bits to tell the pixels apart with some to spare for the rounding errors
+            int bits = (int)ceil(-log2(_scale / _mainWidth)) + 64;
+            int limbs = FixedPoint::limbsForBits(bits);
+
+            // center is stored negated
+            FixedPoint cx = (-_deepCenterX).withPrecision(limbs);
+            FixedPoint cy = (-_deepCenterY).withPrecision(limbs);
+            if (_orbit.iterations == _iterations && _orbit.x == cx && _orbit.y == cy)
+                return;
+
+            _orbit.x = cx;
+            _orbit.y = cy;
+            _orbit.iterations = _iterations;
+
+            // starts at 0 so that pixels can go back to the start of the orbit,
+            // pixels need one point more than the number of iterations
+            _orbit.points.assign({ 0.0, 0.0 });
+            FixedPoint zx = cx;
+            FixedPoint zy = cy;
+            for (int i = 0; i < _iterations; i++)
+            {
+                double x = zx.toDouble();
+                double y = zy.toDouble();
+                _orbit.points.push_back(x);
+                _orbit.points.push_back(y);
+                if (x * x + y * y > 4.0)
+                    break;
+
+                FixedPoint xy = zx * zy;
+                zx = zx * zx - zy * zy + cx;
+                zy = xy + xy + cy;
+            }
+
+            vector<float> pointsF(_orbit.points.begin(), _orbit.points.end());
+            glNamedBufferData(_orbit.bufferF, pointsF.size() * sizeof(float), pointsF.data(), GL_STATIC_DRAW);
+            glNamedBufferData(_orbit.bufferD, _orbit.points.size() * sizeof(double), _orbit.points.data(), GL_STATIC_DRAW);
+        }
+
+        void _updateSeries()
+        {
+            using Complex::cMul;
+
+            int orbitLength = (int)_orbit.points.size() / 2;
+            auto orbitPoint = [](int m) { return DVec2(_orbit.points[m * 2], _orbit.points[m * 2 + 1]); };
+
+            // the series is checked against pixels in the corners and in the middles of the edges
+            double hx = 0.5;
+            double hy = 0.5 * _mainHeight / _mainWidth;
+            DVec2 probes[8]{ { -hx, -hy }, { 0, -hy }, { hx, -hy }, { -hx, 0 }, { hx, 0 }, { -hx, hy }, { 0, hy }, { hx, hy } };
+            DVec2 probeDz[8];
+            for (int p = 0; p < 8; p++)
+                probeDz[p] = probes[p] * _scale;
+
+            // dz of all pixels after the first iteration is dc = u * scale
+            DVec2 a{ _scale, 0.0 };
+            DVec2 b{ 0.0, 0.0 };
+            DVec2 c{ 0.0, 0.0 };
+            _orbit.skip = 0;
+
+            // pixels read one point past their orbit index, so the series stops two points before the end
+            for (int m = 1; m < orbitLength - 2 && m < _iterations; m++)
+            {
+                DVec2 ref2 = orbitPoint(m) * 2.0;
+                DVec2 nextA = cMul(ref2, a) + DVec2(_scale, 0.0);
+                DVec2 nextB = cMul(ref2, b) + cMul(a, a);
+                DVec2 nextC = cMul(ref2, c) + cMul(a, b) * 2.0;
+
+                // the series is used until its error gets close to the distance between pixels
+                // or until some pixel could escape or go back to the start of the orbit
+                double tolerance = nextA.length() / _mainWidth * _SERIES_TOLERANCE;
+                bool valid = true;
+                for (int p = 0; p < 8 && valid; p++)
+                {
+                    DVec2 dz = probeDz[p];
+                    probeDz[p] = cMul(ref2, dz) + cMul(dz, dz) + probes[p] * _scale;
+
+                    DVec2 u = probes[p];
+                    DVec2 u2 = cMul(u, u);
+                    DVec2 approx = cMul(nextA, u) + cMul(nextB, u2) + cMul(nextC, cMul(u2, u));
+                    double z = (orbitPoint(m + 1) + probeDz[p]).length();
+
+                    valid = z <= 2.0 && z >= probeDz[p].length() && (approx - probeDz[p]).length() <= tolerance;
+                }
+                if (!valid)
+                    break;
+
+                a = nextA;
+                b = nextB;
+                c = nextC;
+                _orbit.skip = m;
+            }
+
+            _orbit.seriesA = a;
+            _orbit.seriesB = b;
+            _orbit.seriesC = c;
         }
 
         void _updateCoefs()
@@ -267,6 +884,39 @@ namespace GLFractal
         }
 
 
+        void _updateParameters()
+        {
+            _Parameters parameters{};
+
+            for (int i = 0; i < _MAX_ROOTS; i++)
+            {
+                parameters.roots[i][0] = _roots[i].x;
+                parameters.roots[i][1] = _roots[i].y;
+            }
+            for (int i = 0; i < _MAX_ROOTS + 1; i++)
+            {
+                parameters.coefs[i][0] = _coefs[i].x;
+                parameters.coefs[i][1] = _coefs[i].y;
+            }
+            for (int i = 0; i < _MAX_CONSTANTS; i++)
+            {
+                parameters.constants[i][0] = (float)_constants[i].x;
+                parameters.constants[i][1] = (float)_constants[i].y;
+            }
+            parameters.rootCount = _rootCount;
+            parameters.coefCount = _coefCount;
+            parameters.constantCount = _constantCount;
+
+            // the buffer is sent only when the parameters have changed
+            if (memcmp(&parameters, &_parameters, sizeof(_Parameters)) == 0)
+                return;
+
+            _parameters = parameters;
+            glBindBuffer(GL_UNIFORM_BUFFER, _buffers.parameterUBO);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(_Parameters), &_parameters);
+        }
+
+
         //==================================<<INICIALIZATION>>==================================//
 
         GLFResult _init()
@@ -276,6 +926,8 @@ namespace GLFractal
             glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
             glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
             glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+            // headless rendering needs only the context
+            glfwWindowHint(GLFW_VISIBLE, _initialSettings.headless ? GLFW_FALSE : GLFW_TRUE);
 
             // initialize glfw window
             _window = glfwCreateWindow(_WIN_WIDTH, _WIN_HEIGHT, "Project Fractals", NULL, NULL);
@@ -295,6 +947,8 @@ namespace GLFractal
 
             // setting on mouse move handler
             glfwSetCursorPosCallback(_window, _mouseMoveCallback);
+            // window contents may be lost when it is covered
+            glfwSetWindowRefreshCallback(_window, _windowRefreshCallback);
 
             return GLFResult::OK;
         }
@@ -305,12 +959,11 @@ namespace GLFractal
             _fractals.mandelbrotF = Shader("shader.vert", "mandelbrot_f.frag", [](Shader& shader)
             {
                 shader.use();
-                shader.setInt("texture1", 0);
-                shader.setFloat("scale", (float)_scale);
-                shader.setFloat2("center", (Vec2)_center);
-                shader.setInt("iter", _iterations);
-                shader.setFloat("colorCount", _colorCount);
-                shader.setFloat3("color", _color);
+                shader.setFloat(_uniforms.scale, (float)_scale);
+                shader.setFloat2(_uniforms.center, (Vec2)_center);
+                shader.setInt(_uniforms.iterStart, _progress.start);
+                shader.setInt(_uniforms.iterEnd, _progress.end);
+                shader.setFloat(_uniforms.periodTolerance, (float)_periodTolerance());
             });
             if (!_fractals.mandelbrotF.isCreated())
                 return GLFResult::SHADER_INIT_ERROR;
@@ -320,28 +973,72 @@ namespace GLFractal
             _fractals.mandelbrotD = Shader("shader.vert", "mandelbrot_d.frag", [](Shader& shader)
                 {
                     shader.use();
-                    shader.setInt("texutre1", 0);
-                    shader.setDouble("scale", _scale);
-                    shader.setDouble2("center", _center);
-                    shader.setInt("iter", _iterations);
-                    shader.setFloat("colorCount", _colorCount);
-                    shader.setFloat3("color", _color);
+                    shader.setDouble(_uniforms.scale, _scale);
+                    shader.setDouble2(_uniforms.center, _center);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
+                    shader.setDouble(_uniforms.periodTolerance, _periodTolerance());
                 });
             if (!_fractals.mandelbrotD.isCreated())
                 return GLFResult::SHADER_INIT_ERROR;
             _fractals.mandelbrotD.update();
 
+            // double-float mandelbrot shader
+            _fractals.mandelbrotDF = Shader("shader.vert", "mandelbrot_df.frag", [](Shader& shader)
+                {
+                    shader.use();
+                    shader.setDoubleFloat(_uniforms.scale, _scale);
+                    shader.setDoubleFloat2(_uniforms.center, _center);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
+                    shader.setFloat(_uniforms.periodTolerance, (float)_periodTolerance());
+                });
+            if (!_fractals.mandelbrotDF.isCreated())
+                return GLFResult::SHADER_INIT_ERROR;
+            _fractals.mandelbrotDF.update();
+
+            // float mandelbrot set with perturbation
+            _fractals.perturbationF = Shader("shader.vert", "mandelbrot_perturbation_f.frag", [](Shader& shader)
+                {
+                    shader.use();
+                    shader.setFloat(_uniforms.scale, (float)_scale);
+                    shader.setInt(_uniforms.orbitLength, (int)_orbit.points.size() / 2);
+                    shader.setFloat2(_uniforms.seriesA, (Vec2)_orbit.seriesA);
+                    shader.setFloat2(_uniforms.seriesB, (Vec2)_orbit.seriesB);
+                    shader.setFloat2(_uniforms.seriesC, (Vec2)_orbit.seriesC);
+                    shader.setInt(_uniforms.seriesSkip, _orbit.skip);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
+                });
+            if (!_fractals.perturbationF.isCreated())
+                return GLFResult::SHADER_INIT_ERROR;
+
+            // double mandelbrot set with perturbation
+            _fractals.perturbationD = Shader("shader.vert", "mandelbrot_perturbation_d.frag", [](Shader& shader)
+                {
+                    shader.use();
+                    shader.setDouble(_uniforms.scale, _scale);
+                    shader.setInt(_uniforms.orbitLength, (int)_orbit.points.size() / 2);
+                    shader.setDouble2(_uniforms.seriesA, _orbit.seriesA);
+                    shader.setDouble2(_uniforms.seriesB, _orbit.seriesB);
+                    shader.setDouble2(_uniforms.seriesC, _orbit.seriesC);
+                    shader.setInt(_uniforms.seriesSkip, _orbit.skip);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
+                });
+            if (!_fractals.perturbationD.isCreated())
+                return GLFResult::SHADER_INIT_ERROR;
+
             // selector mandelbrot set
             _fractals.mandelbrotSelector = Shader("shader.vert", "mandelbrot_selector.frag", [](Shader& shader)
                 {
                     shader.use();
-                    shader.setInt("texture1", 0);
-                    shader.setFloat("scale", _selScale);
-                    shader.setFloat2("center", _selCenter);
-                    shader.setInt("iter", _selIterations);
-                    shader.setFloat3("color", _color);
-                    shader.setFloat("colorCount", _selColorCount);
-                    shader.setFloat2("constant", (Vec2)_constants[0]);
+                    shader.setInt(_uniforms.texture1, 0);
+                    shader.setFloat(_uniforms.scale, _selScale);
+                    shader.setFloat2(_uniforms.center, _selCenter);
+                    shader.setInt(_uniforms.iter, _selIterations);
+                    shader.setFloat3(_uniforms.color, _color);
+                    shader.setFloat(_uniforms.colorCount, _selColorCount);
                 });
             if (!_fractals.mandelbrotSelector.isCreated())
                 return GLFResult::SHADER_INIT_ERROR;
@@ -351,13 +1048,12 @@ namespace GLFractal
             _fractals.juliaF = Shader("shader.vert", "julia_f.frag", [](Shader& shader)
                 {
                     shader.use();
-                    shader.setInt("texture1", 0);
-                    shader.setFloat("scale", (float)_scale);
-                    shader.setFloat2("center", (Vec2)_center);
-                    shader.setInt("iter", _iterations);
-                    shader.setFloat3("color", _color);
-                    shader.setFloat("colorCount", _colorCount);
-                    shader.setFloat2("constant", (Vec2)_constants[0]);
+                    shader.setFloat(_uniforms.scale, (float)_scale);
+                    shader.setFloat2(_uniforms.center, (Vec2)_center);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
+                    shader.setFloat(_uniforms.periodTolerance, (float)_periodTolerance());
+                    shader.setFloat2(_uniforms.constant, (Vec2)_constants[0]);
                 });
             if (!_fractals.juliaF.isCreated())
                 return GLFResult::SHADER_INIT_ERROR;
@@ -367,31 +1063,40 @@ namespace GLFractal
             _fractals.juliaD = Shader("shader.vert", "julia_d.frag", [](Shader& shader)
                 {
                     shader.use();
-                    shader.setInt("texture1", 0);
-                    shader.setDouble("scale", _scale);
-                    shader.setDouble2("center", _center);
-                    shader.setInt("iter", _iterations);
-                    shader.setFloat3("color", _color);
-                    shader.setFloat("colorCount", _colorCount);
-                    shader.setDouble2("constant", _constants[0]);
+                    shader.setDouble(_uniforms.scale, _scale);
+                    shader.setDouble2(_uniforms.center, _center);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
+                    shader.setDouble(_uniforms.periodTolerance, _periodTolerance());
+                    shader.setDouble2(_uniforms.constant, _constants[0]);
                 });
             if (!_fractals.juliaF.isCreated())
                 return GLFResult::SHADER_INIT_ERROR;
             _fractals.juliaD.update();
 
+            // double-float julia shader
+            _fractals.juliaDF = Shader("shader.vert", "julia_df.frag", [](Shader& shader)
+                {
+                    shader.use();
+                    shader.setDoubleFloat(_uniforms.scale, _scale);
+                    shader.setDoubleFloat2(_uniforms.center, _center);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
+                    shader.setFloat(_uniforms.periodTolerance, (float)_periodTolerance());
+                    shader.setDoubleFloat2(_uniforms.constant, _constants[0]);
+                });
+            if (!_fractals.juliaDF.isCreated())
+                return GLFResult::SHADER_INIT_ERROR;
+            _fractals.juliaDF.update();
+
             // newton fractal
             _fractals.newtonCoefF = Shader("shader.vert", "newton_coef_f.frag", [](Shader& shader)
                 {
                     shader.use();
-                    shader.setInt("texture1", 0);
-                    shader.setFloat("scale", (float)_scale);
-                    shader.setFloat2("center", (Vec2)_center);
-                    shader.setInt("iter", _iterations / 10);
-                    shader.setFloat3("color", _color);
-                    shader.setFloat2Array("roots", _MAX_ROOTS, _roots);
-                    shader.setInt("rootCount", _rootCount);
-                    shader.setFloat2Array("coefs", _MAX_ROOTS + 1, _coefs);
-                    shader.setInt("coefCount", _coefCount);
+                    shader.setFloat(_uniforms.scale, (float)_scale);
+                    shader.setFloat2(_uniforms.center, (Vec2)_center);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
                 });
             if (!_fractals.newtonCoefF.isCreated())
                 return GLFResult::SHADER_INIT_ERROR;
@@ -401,35 +1106,38 @@ namespace GLFractal
             _fractals.newtonCoefD = Shader("shader.vert", "newton_coef_d.frag", [](Shader& shader)
                 {
                     shader.use();
-                    shader.setInt("texture1", 0);
-                    shader.setDouble("scale", _scale);
-                    shader.setDouble2("center", _center);
-                    shader.setInt("iter", _iterations / 10);
-                    shader.setFloat3("color", _color);
-                    shader.setFloat2Array("roots", _MAX_ROOTS, _roots);
-                    shader.setInt("rootCount", _rootCount);
-                    shader.setFloat2Array("coefs", _MAX_ROOTS + 1, _coefs);
-                    shader.setInt("coefCount", _coefCount);
+                    shader.setDouble(_uniforms.scale, _scale);
+                    shader.setDouble2(_uniforms.center, _center);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
                 });
             if (!_fractals.newtonCoefD.isCreated())
                 return GLFResult::SHADER_INIT_ERROR;
             _fractals.newtonCoefD.update();
 
+            // double-float newton fractal
+            _fractals.newtonCoefDF = Shader("shader.vert", "newton_coef_df.frag", [](Shader& shader)
+                {
+                    shader.use();
+                    shader.setDoubleFloat(_uniforms.scale, _scale);
+                    shader.setDoubleFloat2(_uniforms.center, _center);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
+                });
+            if (!_fractals.newtonCoefDF.isCreated())
+                return GLFResult::SHADER_INIT_ERROR;
+            _fractals.newtonCoefDF.update();
+
             // nova fractal
             _fractals.novaF = Shader("shader.vert", "nova_f.frag", [](Shader& shader)
                 {
                     shader.use();
-                    shader.setInt("texture1", 0);
-                    shader.setFloat("scale", (float)_scale);
-                    shader.setFloat2("center", (Vec2)_center);
-                    shader.setInt("iter", _iterations / 10);
-                    shader.setFloat3("color", _color);
-                    shader.setFloat2Array("roots", _MAX_ROOTS, _roots);
-                    shader.setInt("rootCount", _rootCount);
-                    shader.setFloat2Array("coefs", _MAX_ROOTS + 1, _coefs);
-                    shader.setInt("coefCount", _coefCount);
-                    shader.setFloat2("adder", (Vec2)_constants[0]);
-                    shader.setFloat2("multiplier", (Vec2)_constants[1]);
+                    shader.setFloat(_uniforms.scale, (float)_scale);
+                    shader.setFloat2(_uniforms.center, (Vec2)_center);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
+                    shader.setFloat2(_uniforms.adder, (Vec2)_constants[0]);
+                    shader.setFloat2(_uniforms.multiplier, (Vec2)_constants[1]);
                 });
             if (!_fractals.novaF.isCreated())
                 return GLFResult::SHADER_INIT_ERROR;
@@ -439,39 +1147,110 @@ namespace GLFractal
             _fractals.novaD = Shader("shader.vert", "nova_d.frag", [](Shader& shader)
                 {
                     shader.use();
-                    shader.setInt("texture1", 0);
-                    shader.setDouble("scale", _scale);
-                    shader.setDouble2("center", _center);
-                    shader.setInt("iter", _iterations / 10);
-                    shader.setFloat3("color", _color);
-                    shader.setFloat2Array("roots", _MAX_ROOTS, _roots);
-                    shader.setInt("rootCount", _rootCount);
-                    shader.setFloat2Array("coefs", _MAX_ROOTS + 1, _coefs);
-                    shader.setInt("coefCount", _coefCount);
-                    shader.setDouble2("adder", _constants[0]);
-                    shader.setDouble2("multiplier", _constants[1]);
+                    shader.setDouble(_uniforms.scale, _scale);
+                    shader.setDouble2(_uniforms.center, _center);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
+                    shader.setDouble2(_uniforms.adder, _constants[0]);
+                    shader.setDouble2(_uniforms.multiplier, _constants[1]);
                 });
             if (!_fractals.novaD.isCreated())
                 return GLFResult::SHADER_INIT_ERROR;
             _fractals.novaD.update();
 
+            // nova fractal double-float
+            _fractals.novaDF = Shader("shader.vert", "nova_df.frag", [](Shader& shader)
+                {
+                    shader.use();
+                    shader.setDoubleFloat(_uniforms.scale, _scale);
+                    shader.setDoubleFloat2(_uniforms.center, _center);
+                    shader.setInt(_uniforms.iterStart, _progress.start);
+                    shader.setInt(_uniforms.iterEnd, _progress.end);
+                    shader.setDoubleFloat2(_uniforms.adder, _constants[0]);
+                    shader.setDoubleFloat2(_uniforms.multiplier, _constants[1]);
+                });
+            if (!_fractals.novaDF.isCreated())
+                return GLFResult::SHADER_INIT_ERROR;
+            _fractals.novaDF.update();
+
+            // colors the main view from the iteration state
+            _fractals.colorize = Shader("shader.vert", "colorize.frag", [](Shader& shader)
+                {
+                    shader.use();
+                    shader.setInt(_uniforms.texture1, 0);
+                    shader.setDouble(_uniforms.scale, _scale);
+                    shader.setDouble2(_uniforms.center, _center);
+                    shader.setInt(_uniforms.iter, _progress.total);
+                    shader.setFloat3(_uniforms.color, _color);
+                    shader.setFloat(_uniforms.colorCount, _colorCount);
+                    shader.setInt(_uniforms.mode, _frac == Fractal::NEWTON ? 1 : _frac == Fractal::NOVA ? 2 : 0);
+
+                    shader.setInt(_uniforms.preview, 2);
+                    shader.setInt(_uniforms.usePreview, _preview.valid);
+                    if (_preview.valid)
+                    {
+                        // pixels of the main view are mapped to the preview in pixels of the image
+                        double pixels = _views.main.imageWidth / _preview.scale;
+                        shader.setFloat2(_uniforms.renderSize, (float)_views.main.imageWidth, (float)_views.main.imageHeight);
+                        shader.setFloat(_uniforms.previewRatio, (float)(_scale / _preview.scale));
+                        shader.setFloat2(_uniforms.previewOffset,
+                            (float)((_preview.centerX - _deepCenterX).toDouble() * pixels),
+                            (float)((_preview.centerY - _deepCenterY).toDouble() * pixels));
+                    }
+                });
+            if (!_fractals.colorize.isCreated())
+                return GLFResult::SHADER_INIT_ERROR;
+            _fractals.colorize.update();
+
+            // marks the pixels of the main view that are antialiased
+            _fractals.edges = Shader("shader.vert", "edges.frag", [](Shader& shader)
+                {
+                    shader.use();
+                    shader.setInt(_uniforms.mode, _frac == Fractal::NEWTON ? 1 : _frac == Fractal::NOVA ? 2 : 0);
+                });
+            if (!_fractals.edges.isCreated())
+                return GLFResult::SHADER_INIT_ERROR;
+            _fractals.edges.update();
+
+            // replaces the marked pixels with the average of their samples
+            _fractals.antialias = Shader("shader.vert", "antialias.frag", [](Shader& shader)
+                {
+                    shader.use();
+                    shader.setInt(_uniforms.samples, 3);
+                    shader.setFloat(_uniforms.sampleCount, (float)_antialias.samples);
+                });
+            if (!_fractals.antialias.isCreated())
+                return GLFResult::SHADER_INIT_ERROR;
+            _fractals.antialias.update();
+
             _fractals.selector = Shader("shader.vert", "selector.frag", [](Shader& shader)
                 {
                     shader.use();
-                    shader.setInt("texture1", 0);
-                    shader.setFloat("scale", _selScale);
-                    shader.setFloat2("center", _selCenter);
-                    shader.setFloat2Array("constants", _MAX_CONSTANTS, _constants);
-                    shader.setInt("constantCount", _constantCount);
+                    shader.setInt(_uniforms.texture1, 0);
+                    shader.setFloat(_uniforms.scale, _selScale);
+                    shader.setFloat2(_uniforms.center, _selCenter);
                 });
             if (!_fractals.selector.isCreated())
                 return GLFResult::SHADER_INIT_ERROR;
             _fractals.selector.update();
 
+            _fractals.markers = Shader("shader.vert", "markers.frag", [](Shader& shader)
+                {
+                    shader.use();
+                    shader.setInt(_uniforms.texture1, 0);
+                    shader.setFloat(_uniforms.scale, _selScale);
+                    shader.setFloat2(_uniforms.center, _selCenter);
+                    shader.setInt(_uniforms.markerCount, _frac == Fractal::NOVA ? _constantCount : 1);
+                    shader.setInt(_uniforms.gradient, _frac == Fractal::NOVA);
+                });
+            if (!_fractals.markers.isCreated())
+                return GLFResult::SHADER_INIT_ERROR;
+            _fractals.markers.update();
+
             _fractals.debug = Shader("shader.vert", "debug.frag", [](Shader& shader)
                 {
                     shader.use();
-                    shader.setInt("texture1", 0);
+                    shader.setInt(_uniforms.texture1, 0);
                 });
             if (!_fractals.debug.isCreated())
                 return GLFResult::SHADER_INIT_ERROR;
@@ -482,7 +1261,16 @@ namespace GLFractal
 
         GLFResult _initBuffers()
         {
-            // main view
+            // main view fills its whole framebuffer, texture coordinates keep the pixels square
+            const float aspect = (float)_mainHeight / _mainWidth;
+            const float mainVertices[] =
+            {
+                -1.0f,  1.0f, 0.0f,     0.5f + aspect / 2, 0.0f,
+                 1.0f,  1.0f, 0.0f,     0.5f + aspect / 2, 1.0f,
+                 1.0f, -1.0f, 0.0f,     0.5f - aspect / 2, 1.0f,
+                -1.0f, -1.0f, 0.0f,     0.5f - aspect / 2, 0.0f
+            };
+
             glGenVertexArrays(1, &_buffers.mainVAO);
             glGenBuffers(1, &_buffers.mainVBO);
             glGenBuffers(1, &_buffers.mainEBO);
@@ -490,7 +1278,7 @@ namespace GLFractal
             glBindVertexArray(_buffers.mainVAO);
 
             glBindBuffer(GL_ARRAY_BUFFER, _buffers.mainVBO);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(_mainVertices), _mainVertices, GL_STATIC_DRAW);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(mainVertices), mainVertices, GL_STATIC_DRAW);
 
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffers.mainEBO);
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_rectIndices), _rectIndices, GL_STATIC_DRAW);
@@ -520,9 +1308,216 @@ namespace GLFractal
             glEnableVertexAttribArray(1);
             glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
 
+            // parameters shared by the shaders
+            glGenBuffers(1, &_buffers.parameterUBO);
+            glBindBuffer(GL_UNIFORM_BUFFER, _buffers.parameterUBO);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(_Parameters), NULL, GL_DYNAMIC_DRAW);
+            glBindBufferBase(GL_UNIFORM_BUFFER, 0, _buffers.parameterUBO);
+
+            // offset of the texture coordinates, it is zero except for the antialiasing samples
+            const float jitter[2] = { 0.0f, 0.0f };
+            glGenBuffers(1, &_buffers.samplingUBO);
+            glBindBuffer(GL_UNIFORM_BUFFER, _buffers.samplingUBO);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(jitter), jitter, GL_DYNAMIC_DRAW);
+            glBindBufferBase(GL_UNIFORM_BUFFER, 1, _buffers.samplingUBO);
+
+            // counts the pixels marked for antialiasing
+            glGenBuffers(1, &_antialias.counter);
+            glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _antialias.counter);
+            glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(unsigned int), NULL, GL_DYNAMIC_READ);
+            glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, _antialias.counter);
+
+            // reference orbit for perturbation, the data is uploaded when it is computed
+            glGenBuffers(1, &_orbit.bufferF);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, _orbit.bufferF);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, _orbit.bufferF);
+            glGenBuffers(1, &_orbit.bufferD);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, _orbit.bufferD);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, _orbit.bufferD);
+
+            // invalid root count forces the first upload
+            _parameters = _Parameters{};
+            _parameters.rootCount = -1;
+            _updateParameters();
+
+            return GLFResult::OK;
+        }
+
+        GLFResult _initViews()
+        {
+            GLFResult result{ GLFResult::OK };
+            if ((result = _createView(_views.main, 0, 0, _mainWidth, _mainHeight)) != GLFResult::OK)
+                return result;
+            if ((result = _createView(_views.selector, _VIEW_WIDTH, 0, _SMALL_WIDTH, _SMALL_WIDTH)) != GLFResult::OK)
+                return result;
+
+            // antialiasing marks pixels in the stencil buffer of the main view and adds up their samples
+            glGenRenderbuffers(1, &_antialias.stencil);
+            glBindRenderbuffer(GL_RENDERBUFFER, _antialias.stencil);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_STENCIL_INDEX8, _views.main.width, _views.main.height);
+            glBindFramebuffer(GL_FRAMEBUFFER, _views.main.fbo);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _antialias.stencil);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+                return GLFResult::FRAMEBUFFER_INIT_ERROR;
+
+            glGenTextures(1, &_antialias.texture);
+            glBindTexture(GL_TEXTURE_2D, _antialias.texture);
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA32F, _views.main.width, _views.main.height);
+            glGenFramebuffers(1, &_antialias.fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, _antialias.fbo);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _antialias.texture, 0);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _antialias.stencil);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+                return GLFResult::FRAMEBUFFER_INIT_ERROR;
+
+            // preview is scaled so it is filtered
+            glGenTextures(1, &_preview.texture);
+            glBindTexture(GL_TEXTURE_2D, _preview.texture);
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, _views.main.width, _views.main.height);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            // images rendered at lower resolution are scaled into the preview
+            glGenFramebuffers(1, &_preview.fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, _preview.fbo);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _preview.texture, 0);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+                return GLFResult::FRAMEBUFFER_INIT_ERROR;
+
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+            // everything has to be rendered before the first frame
+            _dirty = _RenderChange::MAIN | _RenderChange::SELECTOR;
+
+            return GLFResult::OK;
+        }
+
+        GLFResult _createView(_RetainedView& view, int x, int y, int width, int height)
+        {
+            view.x = x;
+            view.y = y;
+            view.width = width;
+            view.height = height;
+            view.imageWidth = width;
+            view.imageHeight = height;
+
+            glGenTextures(1, &view.texture);
+            glBindTexture(GL_TEXTURE_2D, view.texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+            glGenFramebuffers(1, &view.fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, view.fbo);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, view.texture, 0);
+
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+                return GLFResult::FRAMEBUFFER_INIT_ERROR;
+
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            return GLFResult::OK;
+        }
+
+        GLFResult _initProgress()
+        {
+            _createStateImages(_progress.zState, _progress.iterState, _progress.refState);
+            _createStateImages(_progress.zSpare, _progress.iterSpare, _progress.refSpare);
+
+            if (glGetError() != GL_NO_ERROR)
+                return GLFResult::FRAMEBUFFER_INIT_ERROR;
+
+            _progress.start = 0;
+            _progress.end = 0;
+            _progress.total = 0;
+            _progress.shift = IVec2(0, 0);
+
+            return GLFResult::OK;
+        }
+
+        GLFResult _initTiles()
+        {
+            if (!_tiles.enabled)
+                return GLFResult::OK;
+
+            // all the tiles of the image have to fit into one dispatch, otherwise the fragment shaders are used
+            int maxGroups;
+            glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, 0, &maxGroups);
+            int tileCount = ((_views.main.width + _TILE_SIZE - 1) / _TILE_SIZE) * ((_views.main.height + _TILE_SIZE - 1) / _TILE_SIZE);
+            if (tileCount > maxGroups || _views.main.width > (_TILE_SIZE << 16) || _views.main.height > (_TILE_SIZE << 16))
+            {
+                _tiles.enabled = false;
+                return GLFResult::OK;
+            }
+
+            // compute versions share the uniforms of the iteration shaders
+            const pair<Shader*, const char*> kernels[] =
+            {
+                { &_fractals.mandelbrotF, "mandelbrot_f.frag" },
+                { &_fractals.mandelbrotD, "mandelbrot_d.frag" },
+                { &_fractals.mandelbrotDF, "mandelbrot_df.frag" },
+                { &_fractals.perturbationF, "mandelbrot_perturbation_f.frag" },
+                { &_fractals.perturbationD, "mandelbrot_perturbation_d.frag" },
+                { &_fractals.juliaF, "julia_f.frag" },
+                { &_fractals.juliaD, "julia_d.frag" },
+                { &_fractals.juliaDF, "julia_df.frag" },
+                { &_fractals.newtonCoefF, "newton_coef_f.frag" },
+                { &_fractals.newtonCoefD, "newton_coef_d.frag" },
+                { &_fractals.newtonCoefDF, "newton_coef_df.frag" },
+                { &_fractals.novaF, "nova_f.frag" },
+                { &_fractals.novaD, "nova_d.frag" },
+                { &_fractals.novaDF, "nova_df.frag" },
+            };
+            for (const auto& [fragment, path] : kernels)
+            {
+                function<void(Shader&)> update = fragment->updateFun;
+                Shader kernel = Shader::compute("tiles.comp", path, [update](Shader& shader)
+                    {
+                        update(shader);
+                        shader.setInt2(_uniforms.renderSize, _views.main.imageWidth, _views.main.imageHeight);
+                        shader.setFloat(_uniforms.aspect, (float)_mainHeight / _mainWidth);
+                        shader.setInt2(_uniforms.boundsMin, _tiles.bounds[0], _tiles.bounds[1]);
+                        shader.setInt2(_uniforms.boundsMax, _tiles.bounds[0] + _tiles.bounds[2], _tiles.bounds[1] + _tiles.bounds[3]);
+                        shader.setInt(_uniforms.resultFinishes, _frac != Fractal::NOVA);
+                    });
+                if (!kernel.isCreated())
+                    return GLFResult::SHADER_INIT_ERROR;
+                _tiles.kernels[fragment] = kernel;
+            }
+
+            // the counts are followed by the y and z of the dispatch, which stay 1
+            const unsigned int dispatch[3] = { 0, 1, 1 };
+            GLsizeiptr size = sizeof(dispatch) + tileCount * sizeof(unsigned int);
+            for (unsigned int* buffer : { &_tiles.current, &_tiles.next })
+            {
+                glCreateBuffers(1, buffer);
+                glNamedBufferStorage(*buffer, size, NULL, GL_DYNAMIC_STORAGE_BIT);
+                glNamedBufferSubData(*buffer, 0, sizeof(dispatch), dispatch);
+            }
+
             return GLFResult::OK;
         }
 
+        void _createStateImages(unsigned int& zState, unsigned int& iterState, unsigned int& refState)
+        {
+            // z of each pixel (two floats or two doubles stored as bits)
+            glGenTextures(1, &zState);
+            glBindTexture(GL_TEXTURE_2D, zState);
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA32UI, _views.main.width, _views.main.height);
+
+            // number of iterations done and the result of each pixel
+            glGenTextures(1, &iterState);
+            glBindTexture(GL_TEXTURE_2D, iterState);
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RG32I, _views.main.width, _views.main.height);
+
+            // position in the reference orbit of each pixel
+            glGenTextures(1, &refState);
+            glBindTexture(GL_TEXTURE_2D, refState);
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32I, _views.main.width, _views.main.height);
+        }
+
         GLFResult _loadTexture(GradientPreset gradient)
         {
             Gradient grad = Gradient::fromPreset(gradient);
@@ -570,10 +1565,9 @@ namespace GLFractal
             _fontShader = Shader("text.vert", "text.frag", [](Shader& s)
             {
                 s.use();
-                s.setMatrix4("projection", _projection);
-                s.setFloat3("textColor", _textColor);
-                _fontShader.setInt("font", 1);
-
+                s.setMatrix4(_uniforms.projection, _projection);
+                s.setFloat3(_uniforms.textColor, _textColor);
+                s.setInt(_uniforms.font, 1);
             });
 
             if (!_fontShader.isCreated())
@@ -593,24 +1587,60 @@ namespace GLFractal
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
             // prepare buffers for rendering text
-            glGenVertexArrays(1, &_buffers.textVAO);
-            glGenBuffers(1, &_buffers.textVBO);
-            glGenBuffers(1, &_buffers.textEBO);
-
-            glBindVertexArray(_buffers.textVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, _buffers.textVBO);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 16 * _MAX_STR_LEN, NULL, GL_DYNAMIC_DRAW);
+            glCreateVertexArrays(1, &_buffers.textVAO);
+            glEnableVertexArrayAttrib(_buffers.textVAO, 0);
+            glVertexArrayAttribFormat(_buffers.textVAO, 0, 4, GL_FLOAT, GL_FALSE, 0);
+            glVertexArrayAttribBinding(_buffers.textVAO, 0, 0);
 
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffers.textEBO);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * 6 * _MAX_STR_LEN, NULL, GL_DYNAMIC_DRAW);
+            if (!_createTextBuffers(_TEXT_GLYPHS))
+                return GLFResult::UNEXPECTED_ERROR;
 
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+            return GLFResult::OK;
+        }
 
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-            glBindVertexArray(0);
+        // replaces the text buffers with the ones for the given number of glyphs in each region,
+        // the glyphs batched so far are moved into the first region of the new buffer
+        bool _createTextBuffers(int capacity)
+        {
+            // the old buffers are deleted once the draws that use them have finished
+            unsigned int oldVBO = _buffers.textVBO;
+            size_t batchOffset = sizeof(float) * 16 * _text.region * _text.capacity;
+            size_t batchSize = sizeof(float) * 16 * _text.count;
+            glDeleteBuffers(1, &_buffers.textEBO);
+            for (GLsync& fence : _text.fences)
+            {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
 
-            return GLFResult::OK;
+            // quads of all regions have the same indices, the draw offsets them by the base vertex
+            vector<unsigned int> indices((size_t)capacity * 6);
+            for (int i = 0; i < capacity; i++)
+            {
+                for (int j = 0; j < 6; j++)
+                    indices[(size_t)i * 6 + j] = i * 4 + _rectIndices[j];
+            }
+            glCreateBuffers(1, &_buffers.textEBO);
+            glNamedBufferStorage(_buffers.textEBO, indices.size() * sizeof(unsigned int), indices.data(), 0);
+
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            const size_t size = sizeof(float) * 16 * capacity * _TEXT_REGIONS;
+            glCreateBuffers(1, &_buffers.textVBO);
+            glNamedBufferStorage(_buffers.textVBO, size, NULL, flags);
+            _text.vertices = (float*)glMapNamedBufferRange(_buffers.textVBO, 0, size, flags);
+
+            glVertexArrayVertexBuffer(_buffers.textVAO, 0, _buffers.textVBO, 0, 4 * sizeof(float));
+            glVertexArrayElementBuffer(_buffers.textVAO, _buffers.textEBO);
+
+            if (_text.vertices && batchSize > 0)
+                glCopyNamedBufferSubData(oldVBO, _buffers.textVBO, batchOffset, 0, batchSize);
+            glDeleteBuffers(1, &oldVBO);
+
+            _text.capacity = _text.vertices ? capacity : 0;
+            _text.region = 0;
+            if (!_text.vertices)
+                _text.count = 0;
+            return _text.vertices != nullptr;
         }
 
 
@@ -618,59 +1648,75 @@ namespace GLFractal
 
         void _processInput(GLFWwindow* window)
         {
+            Tracer::Scope trace("_processInput");
             // exit on ESC
             if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
                 glfwSetWindowShouldClose(window, true);
+
+            _RenderChange change = _RenderChange::NONE;
+            _RenderChange input = _RenderChange::NONE;
             
             switch (_frac)
             {
             case Fractal::HELP:
-                _changeFractal(window);
+                change = _changeFractal(window);
                 break;
             case Fractal::MANDELBROT:
-                _toggleFloatDouble(window);
+                change = _cyclePrecision(window);
+                change |= _cycleAntialiasing(window);
 
-                if (_changeColorCount(window, false) != _RenderChange::NONE) {}
-                else if (_changeIterations(window, false) != _RenderChange::NONE) {}
-                else _changeFractal(window);
+                if ((input = _changeColorCount(window, false)) != _RenderChange::NONE) {}
+                else if ((input = _changeIterations(window, false)) != _RenderChange::NONE) {}
+                else input = _changeFractal(window);
+                change |= input;
 
-                _resetRenderParam(window, false);
+                change |= _resetRenderParam(window, false);
                 break;
             case Fractal::JULIA:
-                _toggleFloatDouble(window);
+                change = _cyclePrecision(window);
+                change |= _cycleAntialiasing(window);
 
-                if (_changeColorCount(window, true) != _RenderChange::NONE) {}
-                else if (_changeIterations(window, true) != _RenderChange::NONE) {}
-                else _changeFractal(window);
+                if ((input = _changeColorCount(window, true)) != _RenderChange::NONE) {}
+                else if ((input = _changeIterations(window, true)) != _RenderChange::NONE) {}
+                else input = _changeFractal(window);
+                change |= input;
 
-                _resetRenderParam(window, true);
+                change |= _resetRenderParam(window, true);
                 break;
             case Fractal::NEWTON:
-                _toggleFloatDouble(window);
+                change = _cyclePrecision(window);
+                change |= _cycleAntialiasing(window);
 
-                if (_changeIterations(window, false) != _RenderChange::NONE) {}
-                else _changeFractal(window);
+                if ((input = _changeIterations(window, false)) != _RenderChange::NONE) {}
+                else input = _changeFractal(window);
+                change |= input;
 
-                _resetRenderParam(window, false);
+                change |= _resetRenderParam(window, false);
                 
-                if (_changeCoefs(window) == _RenderChange::MAIN)
+                if ((input = _changeCoefs(window)) == _RenderChange::MAIN)
                     _updateCoefs();
+                change |= input;
                 break;
             case Fractal::NOVA:
-                _toggleFloatDouble(window);
+                change = _cyclePrecision(window);
+                change |= _cycleAntialiasing(window);
 
-                if (_changeIterations(window, false) != _RenderChange::NONE) {}
-                else _changeFractal(window);
+                if ((input = _changeIterations(window, false)) != _RenderChange::NONE) {}
+                else input = _changeFractal(window);
+                change |= input;
 
-                _resetRenderParam(window, false);
+                change |= _resetRenderParam(window, false);
 
-                if (_changeCoefs(window) == _RenderChange::MAIN)
+                if ((input = _changeCoefs(window)) == _RenderChange::MAIN)
                     _updateCoefs();
+                change |= input;
                 break;
             }
+
+            _invalidate(change);
         }
 
-        _RenderChange _toggleFloatDouble(GLFWwindow* window)
+        _RenderChange _cyclePrecision(GLFWwindow* window)
         {
             static int lastTab = GLFW_RELEASE;
 
@@ -678,7 +1724,11 @@ namespace GLFractal
 
             if (tab != lastTab && tab == GLFW_PRESS)
             {
-                _useDouble = !_useDouble;
+                // auto -> float -> df64 -> double -> auto
+                _precision = _precision == Precision::AUTO ? Precision::FLOAT
+                    : _precision == Precision::FLOAT ? Precision::DF64
+                    : _precision == Precision::DF64 ? Precision::DOUBLE
+                    : Precision::AUTO;
                 lastTab = tab;
                 return _RenderChange::MAIN;
             }
@@ -687,6 +1737,24 @@ namespace GLFractal
             return _RenderChange::NONE;
         }
 
+        _RenderChange _cycleAntialiasing(GLFWwindow* window)
+        {
+            static int lastA = GLFW_RELEASE;
+
+            int a = glfwGetKey(window, GLFW_KEY_A);
+
+            if (a != lastA && a == GLFW_PRESS)
+            {
+                // off -> 4 -> 16 -> off, the colors are restored and the new samples are rendered from them
+                _antialias.samples = _antialias.samples < 4 ? 4 : _antialias.samples < 16 ? 16 : 1;
+                lastA = a;
+                return _RenderChange::COLOR;
+            }
+
+            lastA = a;
+            return _RenderChange::NONE;
+        }
+
         _RenderChange _changeColorCount(GLFWwindow* window, bool allowSelector)
         {
             float newColorCount = 0;
@@ -728,7 +1796,7 @@ namespace GLFractal
                 return _RenderChange::SELECTOR;
             }
             _colorCount = newColorCount;
-            return _RenderChange::MAIN;
+            return _RenderChange::COLOR;
         }
 
         _RenderChange _changeIterations(GLFWwindow* window, bool allowSelector)
@@ -783,34 +1851,34 @@ namespace GLFractal
             if (glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS)
             {
                 _frac = Fractal::MANDELBROT;
-                return _RenderChange::MAIN;
+                return _RenderChange::MAIN | _RenderChange::SELECTOR;
             }
             if (glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS)
             {
                 _frac = Fractal::JULIA;
-                return _RenderChange::MAIN;
+                return _RenderChange::MAIN | _RenderChange::SELECTOR;
             }
             if (glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS)
             {
                 _frac = Fractal::NEWTON;
-                return _RenderChange::MAIN;
+                return _RenderChange::MAIN | _RenderChange::SELECTOR;
             }
             if (glfwGetKey(window, GLFW_KEY_4))
             {
                 _frac = Fractal::NOVA;
-                return _RenderChange::MAIN;
+                return _RenderChange::MAIN | _RenderChange::SELECTOR;
             }
             if (glfwGetKey(window, GLFW_KEY_F1) == GLFW_PRESS)
             {
                 _frac = Fractal::HELP;
-                _useDouble = false;
-                return _RenderChange::MAIN;
+                _debugPage = false;
+                return _RenderChange::MAIN | _RenderChange::SELECTOR;
             }
             if (glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS)
             {
                 _frac = Fractal::HELP;
-                _useDouble = true;
-                return _RenderChange::MAIN;
+                _debugPage = true;
+                return _RenderChange::MAIN | _RenderChange::SELECTOR;
             }
             return _RenderChange::NONE;
         }
@@ -830,18 +1898,21 @@ namespace GLFractal
             if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
                 _iterations = _initialSettings.iterations;
             else if (glfwGetKey(window, GLFW_KEY_LEFT_ALT) == GLFW_PRESS)
+            {
                 _colorCount = _initialSettings.colorCount;
+                return _RenderChange::COLOR;
+            }
             else if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
             {
                 _iterations = _initialSettings.iterations;
                 _colorCount = _initialSettings.colorCount;
-                _center     = _initialSettings.center;
                 _scale      = _initialSettings.scale;
+                _resetCenter();
             }
             else
             {
-                _center = _initialSettings.center;
-                _scale  = _initialSettings.scale;
+                _scale = _initialSettings.scale;
+                _resetCenter();
             }
 
             return _RenderChange::MAIN;
@@ -929,23 +2000,25 @@ namespace GLFractal
             DVec2 delta = current - _mousePos;
             _mousePos = current;
 
+            _RenderChange change = _RenderChange::NONE;
+
             switch (_frac)
             {
             case Fractal::HELP:
                 break;
             case Fractal::MANDELBROT:
-                if (_moveView(window, delta, false) != _RenderChange::NONE) break;
-                if (_scaleView(window, delta, false) != _RenderChange::NONE) break;
+                if ((change = _moveView(window, delta, false)) != _RenderChange::NONE) break;
+                if ((change = _scaleView(window, delta, false)) != _RenderChange::NONE) break;
                 break;
             case Fractal::JULIA:
-                if (_moveConstant(window) != _RenderChange::NONE) break;
-                if (_moveView(window, delta, true) != _RenderChange::NONE) break;
-                if (_scaleView(window, delta, true) != _RenderChange::NONE) break;
+                if ((change = _moveConstant(window)) != _RenderChange::NONE) break;
+                if ((change = _moveView(window, delta, true)) != _RenderChange::NONE) break;
+                if ((change = _scaleView(window, delta, true)) != _RenderChange::NONE) break;
                 break;
             case Fractal::NEWTON:
             {
                 bool cont = true;
-                switch (_moveRoot(window))
+                switch (change = _moveRoot(window))
                 {
                 case _RenderChange::NONE:
                     break;
@@ -960,15 +2033,15 @@ namespace GLFractal
                 if (!cont)
                     break;
 
-                if (_moveView(window, delta, false) != _RenderChange::NONE) break;
-                if (_scaleView(window, delta, false) != _RenderChange::NONE) break;
+                if ((change = _moveView(window, delta, false)) != _RenderChange::NONE) break;
+                if ((change = _scaleView(window, delta, false)) != _RenderChange::NONE) break;
 
                 break;
             }
             case Fractal::NOVA:
             {
                 bool cont = true;
-                switch (_moveRoot(window))
+                switch (change = _moveRoot(window))
                 {
                 case _RenderChange::NONE:
                     break;
@@ -982,11 +2055,18 @@ namespace GLFractal
                 if (!cont)
                     break;
 
-                if (_moveConstants(window) != _RenderChange::NONE) break;
-                if (_moveView(window, delta, true) != _RenderChange::NONE) break;
-                if (_scaleView(window, delta, true) != _RenderChange::NONE) break;
+                if ((change = _moveConstants(window)) != _RenderChange::NONE) break;
+                if ((change = _moveView(window, delta, true)) != _RenderChange::NONE) break;
+                if ((change = _scaleView(window, delta, true)) != _RenderChange::NONE) break;
             }
             }
+
+            _invalidate(change);
+        }
+
+        void _windowRefreshCallback(GLFWwindow* window)
+        {
+            _invalidate(_RenderChange::OVERLAY);
         }
 
         _RenderChange _moveConstant(GLFWwindow* window)
@@ -1000,7 +2080,8 @@ namespace GLFractal
                         (relCur.x - _SMALL_WIDTH / 2) / _SMALL_WIDTH * _selScale - _selCenter.x,
                         (relCur.y - _SMALL_WIDTH / 2) / _SMALL_WIDTH * -_selScale - _selCenter.y
                     );
-                    return _RenderChange::SELECTOR;
+                    // constant is used by the main view, its marker is drawn over the selector
+                    return _RenderChange::MAIN;
                 }
                 return _RenderChange::INVALID;
             }
@@ -1041,7 +2122,7 @@ namespace GLFractal
                     }
 
                     _constants[constantHold] = pos;
-                    return _RenderChange::SELECTOR;
+                    return _RenderChange::MAIN;
                 }
                 constantHold = -1;
                 return _RenderChange::INVALID;
@@ -1107,8 +2188,29 @@ namespace GLFractal
                 return _RenderChange::SELECTOR;
             }
             
-            _center += newCenterDifference * _scale;
-            return _RenderChange::MAIN;
+            // the view is moved by whole pixels so that the pixels that stay in view keep their iterations,
+            // the rest of the movement is added to the next one
+            static DVec2 remainder;
+            remainder += mouseDelta;
+            IVec2 pixels{ remainder };
+            if (pixels.x == 0 && pixels.y == 0)
+                return _RenderChange::INVALID;
+            remainder = remainder - DVec2(pixels);
+
+            // moving in high precision so that deep zooms can be moved around
+            Precision precision = _activePrecision();
+            double pixelSize = _scale / _mainWidth;
+            _deepCenterX = _deepCenterX + FixedPoint(pixels.x * pixelSize);
+            _deepCenterY = _deepCenterY - FixedPoint(pixels.y * pixelSize);
+            _center = DVec2(_deepCenterX.toDouble(), _deepCenterY.toDouble());
+
+            // the state of a different precision can't be continued and unfinished perturbation
+            // pixels are iterated relative to the reference orbit of the old center
+            if (_activePrecision() != precision || (_usePerturbation() && _progress.start < _progress.total))
+                return _RenderChange::MAIN | _RenderChange::PREVIEW;
+
+            _progress.shift += IVec2(pixels.x, -pixels.y);
+            return _RenderChange::SHIFT;
         }
 
         _RenderChange _scaleView(GLFWwindow* window, DVec2 mouseDelta, bool allowSelector)
@@ -1129,33 +2231,733 @@ namespace GLFractal
             }
 
             _scale *= newScaleMultiplier;
-            return _RenderChange::MAIN;
+            return _RenderChange::MAIN | _RenderChange::PREVIEW;
+        }
+
+
+        //==================================<<RENDERING>>==================================//
+
+        GLFResult _renderMain()
+        {
+            Tracer::Scope trace("_renderMain");
+            glBindFramebuffer(GL_FRAMEBUFFER, _views.main.fbo);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            _updateParameters();
+
+            // only one slice of the iterations is done in each frame
+            bool reduced = _frac == Fractal::NEWTON || _frac == Fractal::NOVA;
+            int iterations = reduced ? _iterations / 10 : _iterations;
+            int slice = reduced ? max(_progress.slice / 10, 1) : _progress.slice;
+
+            _progress.total = _frac == Fractal::HELP ? 0 : iterations;
+
+            bool perturbation = _usePerturbation();
+            bool shifted = _progress.shift.x != 0 || _progress.shift.y != 0;
+            if ((_progress.start == 0 || shifted) && _frac != Fractal::HELP && _backend == Backend::GPU
+                && _cache.load(_viewKey(), _progress.iterState))
+            {
+                // the reference orbit is still used by antialiasing and later moves
+                if (perturbation)
+                {
+                    _updateOrbit();
+                    _updateSeries();
+                }
+
+                _progress.shift = IVec2(0, 0);
+                _setResolution(1);
+                _progress.start = _progress.total;
+                _progress.end = _progress.total;
+                _cachePending = false;
+                _colorizeMain();
+                return GLFResult::OK;
+            }
+
+            if (shifted)
+            {
+                GLFResult result = _shiftMain(perturbation);
+                if (result != GLFResult::OK)
+                    return result;
+                _cachePending = true;
+
+                // the view was finished before it was moved, only the uncovered pixels had to be iterated
+                if (_progress.start >= _progress.total)
+                {
+                    _colorizeMain();
+                    return GLFResult::OK;
+                }
+            }
+
+            // new image is rendered at lower resolution while the view keeps changing
+            if (_progress.start == 0)
+            {
+                _setResolution(_frac != Fractal::HELP && _interacting() ? _resolution.adaptive : 1);
+                _cachePending = true;
+            }
+            glViewport(0, 0, _views.main.imageWidth, _views.main.imageHeight);
+
+            _progress.end = _progress.slice > 0 ? min(_progress.start + slice, iterations) : iterations;
+            if (perturbation && _progress.start == 0)
+            {
+                _updateOrbit();
+                _updateSeries();
+
+                // iterations skipped by the series don't count into the first slice
+                if (_progress.slice > 0)
+                    _progress.end = min(_orbit.skip + slice, iterations);
+            }
+
+            if (_backend == Backend::CPU && _frac != Fractal::HELP)
+                return _renderMainCpu();
+
+            // new image or state that was changed outside of the tiles starts from all the tiles of the image
+            bool tiled = _tiles.enabled && _frac != Fractal::HELP;
+            if (tiled && (_progress.start == 0 || !_tiles.listed))
+                _listTiles(0, 0, _views.main.imageWidth, _views.main.imageHeight);
+
+            GLFResult result = _iterateMain(perturbation, tiled);
+            if (result != GLFResult::OK || _frac == Fractal::HELP)
+                return result;
+            _tiles.listed = tiled;
+            _progress.start = _progress.end;
+
+            _colorizeMain();
+
+            return GLFResult::OK;
+        }
+
+        // iteration pass of the main view from _progress.start to _progress.end (the help is drawn instead),
+        // tiled pass iterates the listed tiles with the compute shaders
+        GLFResult _iterateMain(bool perturbation, bool tiled)
+        {
+            glBindImageTexture(0, _progress.zState, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32UI);
+            glBindImageTexture(1, _progress.iterState, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RG32I);
+            glBindImageTexture(2, _progress.refState, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32I);
+
+            // help page doesn't depend on the precision
+            if (_frac == Fractal::HELP)
+            {
+                if (_debugPage)
+                {
+                    _fractals.debug.update();
+                    glBindVertexArray(_buffers.mainVAO);
+                    _draw("draw debug");
+                    return GLFResult::OK;
+                }
+
+                // help is laid out in window coordinates
+                glViewport(-_views.main.x, -_views.main.y, _WIN_WIDTH, _WIN_HEIGHT);
+                _renderHelp();
+                return GLFResult::OK;
+            }
+
+            // choosing fractal to render
+            Shader* shader;
+            switch (_fractal())
+            {
+            case _Fractal::MANDELBROT_F:
+            case _Fractal::MANDELBROT_D:
+            case _Fractal::MANDELBROT_DF:
+                if (perturbation)
+                    shader = _perturbationDouble() ? &_fractals.perturbationD : &_fractals.perturbationF;
+                else if (_activePrecision() == Precision::DF64)
+                    shader = &_fractals.mandelbrotDF;
+                else
+                    shader = _activePrecision() == Precision::DOUBLE ? &_fractals.mandelbrotD : &_fractals.mandelbrotF;
+                break;
+            case _Fractal::JULIA_F:
+                shader = &_fractals.juliaF;
+                break;
+            case _Fractal::JULIA_D:
+                shader = &_fractals.juliaD;
+                break;
+            case _Fractal::JULIA_DF:
+                shader = &_fractals.juliaDF;
+                break;
+            case _Fractal::NEWTON_F:
+                shader = &_fractals.newtonCoefF;
+                break;
+            case _Fractal::NEWTON_D:
+                shader = &_fractals.newtonCoefD;
+                break;
+            case _Fractal::NEWTON_DF:
+                shader = &_fractals.newtonCoefDF;
+                break;
+            case _Fractal::NOVA_F:
+                shader = &_fractals.novaF;
+                break;
+            case _Fractal::NOVA_D:
+                shader = &_fractals.novaD;
+                break;
+            case _Fractal::NOVA_DF:
+                shader = &_fractals.novaDF;
+                break;
+            default:
+                return GLFResult::INVALID_FRACTAL;
+            }
+
+            if (tiled)
+            {
+                _dispatchTiles(_tiles.kernels[shader]);
+                return GLFResult::OK;
+            }
+
+            // iteration pass only writes the state images
+            shader->update();
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            glBindVertexArray(_buffers.mainVAO);
+            _draw("draw iterate");
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+            // next slice and the colorize pass read the state written by this one
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+            return GLFResult::OK;
+        }
+
+        // lists all the tiles of the rectangle for the next dispatch, only its pixels are iterated
+        void _listTiles(int x, int y, int width, int height)
+        {
+            vector<unsigned int> tiles;
+            for (int ty = y / _TILE_SIZE; ty * _TILE_SIZE < y + height; ty++)
+            {
+                for (int tx = x / _TILE_SIZE; tx * _TILE_SIZE < x + width; tx++)
+                    tiles.push_back((unsigned int)tx | (unsigned int)ty << 16);
+            }
+
+            unsigned int count = (unsigned int)tiles.size();
+            glNamedBufferSubData(_tiles.current, 0, sizeof(count), &count);
+            glNamedBufferSubData(_tiles.current, 3 * sizeof(unsigned int), tiles.size() * sizeof(unsigned int), tiles.data());
+
+            _tiles.bounds[0] = x;
+            _tiles.bounds[1] = y;
+            _tiles.bounds[2] = width;
+            _tiles.bounds[3] = height;
+            _tiles.listed = false;
+        }
+
+        // iterates the current tiles, the tiles that still have unfinished pixels become the current ones
+        void _dispatchTiles(Shader& shader)
+        {
+            Tracer::Scope trace("_dispatchTiles");
+            const unsigned int none = 0;
+            glNamedBufferSubData(_tiles.next, 0, sizeof(none), &none);
+
+            shader.update();
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, _tiles.current);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, _tiles.next);
+            glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, _tiles.current);
+            {
+                Tracer::Scope trace("dispatch tiles");
+                glDispatchComputeIndirect(0);
+            }
+
+            // next slice and the colorize pass read the state, the next dispatch reads the listed tiles
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+            swap(_tiles.current, _tiles.next);
+        }
+
+        // moves the state of the main view by the pixels the view has moved by,
+        // the uncovered strips are iterated as far as the rest of the view
+        GLFResult _shiftMain(bool perturbation)
+        {
+            IVec2 shift = _progress.shift;
+            _progress.shift = IVec2(0, 0);
+
+            // nothing is iterated yet, or the image has lower resolution and is rendered again
+            if (_progress.start == 0 || _resolution.reduction > 1)
+            {
+                _progress.start = 0;
+                return GLFResult::OK;
+            }
+
+            int width = _mainWidth - abs(shift.x);
+            int height = _mainHeight - abs(shift.y);
+            if (width <= 0 || height <= 0)
+            {
+                _progress.start = 0;
+                return GLFResult::OK;
+            }
+
+            // uncovered columns over the whole height and uncovered rows between them (x, y, width, height)
+            const int strips[2][4] =
+            {
+                { shift.x > 0 ? 0 : width, 0, abs(shift.x), _mainHeight },
+                { max(shift.x, 0), shift.y > 0 ? 0 : height, width, abs(shift.y) },
+            };
+
+            int level = _progress.start;
+            _progress.start = 0;
+            _progress.end = level;
+            if (perturbation)
+            {
+                _updateOrbit();
+                _updateSeries();
+            }
+
+            GLFResult result{ GLFResult::OK };
+            if (_backend == Backend::CPU)
+            {
+                _cpu.shift(shift.x, shift.y);
+                CpuFractalParams params = _cpuParams();
+                for (const int* strip : strips)
+                    _cpu.iterate(params, 0, level, strip[0], strip[1], strip[2], strip[3]);
+                glTextureSubImage2D(_progress.iterState, 0, 0, 0, _mainWidth, _mainHeight, GL_RG_INTEGER, GL_INT, _cpu.iterState());
+            }
+            else
+            {
+                // copy reads the state written by the shaders
+                glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+                int srcX = max(-shift.x, 0);
+                int srcY = max(-shift.y, 0);
+                int dstX = max(shift.x, 0);
+                int dstY = max(shift.y, 0);
+                glCopyImageSubData(_progress.zState, GL_TEXTURE_2D, 0, srcX, srcY, 0, _progress.zSpare, GL_TEXTURE_2D, 0, dstX, dstY, 0, width, height, 1);
+                glCopyImageSubData(_progress.iterState, GL_TEXTURE_2D, 0, srcX, srcY, 0, _progress.iterSpare, GL_TEXTURE_2D, 0, dstX, dstY, 0, width, height, 1);
+                glCopyImageSubData(_progress.refState, GL_TEXTURE_2D, 0, srcX, srcY, 0, _progress.refSpare, GL_TEXTURE_2D, 0, dstX, dstY, 0, width, height, 1);
+                swap(_progress.zState, _progress.zSpare);
+                swap(_progress.iterState, _progress.iterSpare);
+                swap(_progress.refState, _progress.refSpare);
+
+                // the fragments or tiles outside of the strips are not iterated at all
+                glEnable(GL_SCISSOR_TEST);
+                for (const int* strip : strips)
+                {
+                    if (strip[2] == 0 || strip[3] == 0)
+                        continue;
+                    if (_tiles.enabled)
+                        _listTiles(strip[0], strip[1], strip[2], strip[3]);
+                    else
+                        glScissor(strip[0], strip[1], strip[2], strip[3]);
+                    if ((result = _iterateMain(perturbation, _tiles.enabled)) != GLFResult::OK)
+                        break;
+                }
+                glDisable(GL_SCISSOR_TEST);
+            }
+
+            _progress.start = level;
+            return result;
+        }
+
+        GLFResult _renderMainCpu()
+        {
+            _cpu.iterate(_cpuParams(), _progress.start, _progress.end);
+
+            // the state is colored by the same pass as the state from the shaders
+            glTextureSubImage2D(_progress.iterState, 0, 0, 0, _views.main.imageWidth, _views.main.imageHeight, GL_RG_INTEGER, GL_INT, _cpu.iterState());
+            _progress.start = _progress.end;
+
+            _colorizeMain();
+
+            return GLFResult::OK;
+        }
+
+        // sets the size of the main image to 1 / reduction of the view in each direction
+        void _setResolution(int reduction)
+        {
+            _resolution.reduction = reduction;
+            _views.main.imageWidth = max(_views.main.width / reduction, 1);
+            _views.main.imageHeight = max(_views.main.height / reduction, 1);
+            if (_backend == Backend::CPU)
+                _cpu.resize(_views.main.imageWidth, _views.main.imageHeight);
+        }
+
+        CpuFractalParams _cpuParams()
+        {
+            CpuFractalParams params;
+            params.fractal = _frac;
+            // cpus have fast double arithmetic so df64 isn't emulated there
+            params.useDouble = _activePrecision() != Precision::FLOAT;
+            params.scale = _scale;
+            params.periodTolerance = _periodTolerance();
+            params.iterations = _progress.total;
+            params.subdivision = _subdivision;
+            if (_usePerturbation())
+            {
+                params.perturbation = true;
+                params.useDouble = _perturbationDouble();
+                params.orbit = _orbit.points.data();
+                params.orbitLength = (int)_orbit.points.size() / 2;
+                params.seriesSkip = _orbit.skip;
+                params.seriesA = _orbit.seriesA;
+                params.seriesB = _orbit.seriesB;
+                params.seriesC = _orbit.seriesC;
+            }
+            params.center = _center;
+            params.adder = _constants[0];
+            params.multiplier = _frac == Fractal::NOVA ? _constants[1] : DVec2(1.0, 0.0);
+            params.rootCount = _rootCount;
+            for (int i = 0; i < _rootCount; i++)
+                params.roots[i] = _roots[i];
+            params.coefCount = _coefCount;
+            for (int i = 0; i < _coefCount; i++)
+                params.coefs[i] = _coefs[i];
+            return params;
+        }
+
+        void _colorizeMain()
+        {
+            Tracer::Scope trace("_colorizeMain");
+            // new image replaces the antialiased pixels, they are marked and sampled again
+            _antialias.sample = 0;
+            _antialias.start = 0;
+            _antialias.marked = false;
+
+            glBindFramebuffer(GL_FRAMEBUFFER, _views.main.fbo);
+            glViewport(0, 0, _views.main.imageWidth, _views.main.imageHeight);
+
+            glBindImageTexture(1, _progress.iterState, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RG32I);
+            glBindTextureUnit(2, _preview.texture);
+
+            _fractals.colorize.update();
+            glBindVertexArray(_buffers.mainVAO);
+            _draw("draw colorize");
+
+            // finished image is kept as the preview for the next move or zoom
+            if (_progress.start >= _progress.total)
+            {
+                _blitImage(_views.main, _preview.fbo, 0, 0);
+                _preview.scale = _scale;
+                _preview.centerX = _deepCenterX;
+                _preview.centerY = _deepCenterY;
+                _preview.valid = true;
+
+                if (_cachePending && _resolution.reduction == 1 && _backend == Backend::GPU)
+                {
+                    _cache.store(_viewKey(), _progress.iterState);
+                    _cachePending = false;
+                }
+            }
+        }
+
+        // everything the iterations of the current main view depend on
+        ViewKey _viewKey()
+        {
+            ViewKey key;
+            key.fractal = _frac;
+            key.precision = _activePrecision();
+            key.centerX = _deepCenterX;
+            key.centerY = _deepCenterY;
+            key.scale = _scale;
+            key.iterations = _progress.total;
+            key.periodicityTolerance = _periodicityTolerance;
+
+            if (_frac == Fractal::JULIA || _frac == Fractal::NOVA)
+            {
+                for (int i = 0; i < _MAX_CONSTANTS; i++)
+                    key.parameters.insert(key.parameters.end(), { _constants[i].x, _constants[i].y });
+            }
+            if (_frac == Fractal::NEWTON || _frac == Fractal::NOVA)
+            {
+                for (int i = 0; i < _rootCount; i++)
+                    key.parameters.insert(key.parameters.end(), { _roots[i].x, _roots[i].y });
+            }
+            return key;
+        }
+
+        bool _antialiasPending()
+        {
+            return _antialias.samples > 1 && _antialias.sample < _antialias.samples
+                && _backend == Backend::GPU && _frac != Fractal::HELP
+                && _resolution.reduction == 1 && _progress.start >= _progress.total;
+        }
+
+        GLFResult _antialiasMain()
+        {
+            Tracer::Scope trace("_antialiasMain");
+            glBindFramebuffer(GL_FRAMEBUFFER, _antialias.fbo);
+            glViewport(0, 0, _views.main.width, _views.main.height);
+            glBindVertexArray(_buffers.mainVAO);
+            glEnable(GL_STENCIL_TEST);
+
+            if (!_antialias.marked)
+            {
+                // the sum of the samples and the marks start from zero
+                const float black[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                const int unmarked = 0;
+                unsigned int count = 0;
+                glClearBufferfv(GL_COLOR, 0, black);
+                glClearBufferiv(GL_STENCIL, 0, &unmarked);
+                glNamedBufferSubData(_antialias.counter, 0, sizeof(count), &count);
+
+                glStencilFunc(GL_ALWAYS, 1, 0xFF);
+                glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+                glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                glBindImageTexture(1, _progress.iterState, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RG32I);
+                _fractals.edges.update();
+                _draw("draw edges");
+                glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+
+                // reading the count waits for the pass, this happens once for each image
+                glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+                glGetNamedBufferSubData(_antialias.counter, 0, sizeof(count), &count);
+                _antialias.refined = (double)count / ((double)_views.main.width * _views.main.height);
+                _antialias.marked = true;
+
+                if (count == 0)
+                {
+                    _antialias.sample = _antialias.samples;
+                    glDisable(GL_STENCIL_TEST);
+                    return GLFResult::OK;
+                }
+            }
+
+            // only the marked pixels are iterated and colored
+            glStencilFunc(GL_EQUAL, 1, 0xFF);
+
+            // offset of the sample in pixels (the first one is the center), texture coordinates span the width of the view in both directions
+            double offsetX = fmod(0.5 + _antialias.sample * _R2_X, 1.0) - 0.5;
+            double offsetY = fmod(0.5 + _antialias.sample * _R2_Y, 1.0) - 0.5;
+            _setJitter((float)(offsetX / _views.main.width), (float)(offsetY / _views.main.width));
+
+            int iterations = _progress.total;
+            int slice = _frac == Fractal::NEWTON || _frac == Fractal::NOVA ? max(_progress.slice / 10, 1) : _progress.slice;
+            bool perturbation = _usePerturbation();
+            int end = _progress.slice > 0 ? min(_antialias.start + slice, iterations) : iterations;
+            if (perturbation && _antialias.start == 0 && _progress.slice > 0)
+                end = min(_orbit.skip + slice, iterations);
+
+            // the sample is iterated by the passes of the main view, which read the state and the range from _progress
+            int mainStart = _progress.start;
+            int mainEnd = _progress.end;
+            swap(_progress.zState, _progress.zSpare);
+            swap(_progress.iterState, _progress.iterSpare);
+            swap(_progress.refState, _progress.refSpare);
+            _progress.start = _antialias.start;
+            _progress.end = end;
+
+            // only the fragments pass the stencil test
+            GLFResult result = _iterateMain(perturbation, false);
+
+            swap(_progress.zState, _progress.zSpare);
+            swap(_progress.iterState, _progress.iterSpare);
+            swap(_progress.refState, _progress.refSpare);
+            _progress.start = mainStart;
+            _progress.end = mainEnd;
+            _antialias.start = end;
+
+            // finished sample is colored and added to the sum
+            if (result == GLFResult::OK && _antialias.start >= iterations)
+            {
+                glBindImageTexture(1, _progress.iterSpare, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RG32I);
+                glBindTextureUnit(2, _preview.texture);
+                glBlendFunc(GL_ONE, GL_ONE);
+                _fractals.colorize.update();
+                _draw("draw colorize");
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+                _antialias.sample++;
+                _antialias.start = 0;
+
+                // the average of all samples replaces the marked pixels
+                if (_antialias.sample == _antialias.samples)
+                {
+                    glBindFramebuffer(GL_FRAMEBUFFER, _views.main.fbo);
+                    glBindTextureUnit(3, _antialias.texture);
+                    _fractals.antialias.update();
+                    _draw("draw antialias");
+                }
+            }
+
+            _setJitter(0.0f, 0.0f);
+            glDisable(GL_STENCIL_TEST);
+
+            return result;
+        }
+
+        void _setJitter(float x, float y)
+        {
+            const float jitter[2] = { x, y };
+            glNamedBufferSubData(_buffers.samplingUBO, 0, sizeof(jitter), jitter);
+        }
+
+        GLFResult _renderSelector()
+        {
+            Tracer::Scope trace("_renderSelector");
+            switch (_frac)
+            {
+            case Fractal::JULIA:
+                _fractals.mandelbrotSelector.update();
+                break;
+            case Fractal::NOVA:
+                _constantCount = 2;
+                _updateParameters();
+                _fractals.selector.update();
+                break;
+            default:
+                // there is no selector for this fractal
+                return GLFResult::OK;
+            }
+
+            glBindFramebuffer(GL_FRAMEBUFFER, _views.selector.fbo);
+            glViewport(-_views.selector.x, -_views.selector.y, _WIN_WIDTH, _WIN_HEIGHT);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            glBindVertexArray(_buffers.selVAO);
+            _draw("draw selector");
+
+            return GLFResult::OK;
+        }
+
+        // constants are drawn over the presented selector, so moving them doesn't render the selector again
+        void _renderMarkers()
+        {
+            // julia constant inverts the colors under it
+            if (_frac == Fractal::JULIA)
+                glBlendFuncSeparate(GL_ONE_MINUS_DST_COLOR, GL_ZERO, GL_ZERO, GL_ONE);
+
+            _fractals.markers.update();
+            glBindVertexArray(_buffers.selVAO);
+            _draw("draw markers");
+
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+
+        void _presentView(const _RetainedView& view)
+        {
+            _blitImage(view, 0, view.x, view.y);
+        }
+
+        // copies the image of the view into the framebuffer at (x, y), image with lower resolution is scaled to the size of the view
+        void _blitImage(const _RetainedView& view, unsigned int fbo, int x, int y)
+        {
+            bool scaled = view.imageWidth != view.width || view.imageHeight != view.height;
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, view.fbo);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+            glBlitFramebuffer(
+                0, 0, view.imageWidth, view.imageHeight,
+                x, y, x + view.width, y + view.height,
+                GL_COLOR_BUFFER_BIT, scaled ? GL_LINEAR : GL_NEAREST
+            );
+        }
+
+        // draws the indices of the bound vertex array, each draw is an event of the trace
+        void _draw(const char* name, int count)
+        {
+            Tracer::Scope trace(name);
+            glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, 0);
+        }
+
+        void _composite()
+        {
+            Tracer::Scope trace("_composite");
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, _WIN_WIDTH, _WIN_HEIGHT);
+
+            // clearing display
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            _presentView(_views.main);
+            if (_frac == Fractal::JULIA || _frac == Fractal::NOVA)
+            {
+                _presentView(_views.selector);
+                _renderMarkers();
+            }
+
+            _gpuTimer.begin((int)_GpuPass::TEXT);
+            _renderInfo();
+            _gpuTimer.end();
+        }
+
+        GLFResult _saveMeasurements()
+        {
+            if (!_gpuTimesPath.empty())
+            {
+                // the last passes may still be running
+                _gpuTimer.collect(true);
+                if (!_gpuTimer.save(_gpuTimesPath))
+                    return GLFResult::TIMES_WRITE_ERROR;
+            }
+
+            if (!_tracePath.empty() && !Tracer::save(_tracePath))
+                return GLFResult::TRACE_WRITE_ERROR;
+            return GLFResult::OK;
+        }
+
+        GLFResult _saveView(const _RetainedView& view, string path)
+        {
+            const size_t rowSize = (size_t)view.width * 3;
+            const size_t size = rowSize * view.height;
+
+            // reading the pixels into pixel buffer, mapping it waits for the copy to finish
+            unsigned int pbo;
+            glGenBuffers(1, &pbo);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, view.fbo);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(0, 0, view.width, view.height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+
+            GLFResult result{ GLFResult::OK };
+            const char* pixels = (const char*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+            ofstream file{ path, ios::binary };
+            if (pixels == NULL || !file.is_open())
+                result = GLFResult::OUTPUT_WRITE_ERROR;
+            else
+            {
+                // binary ppm, rows are stored from top to bottom
+                file << "P6\n" << view.width << " " << view.height << "\n255\n";
+                for (int y = view.height - 1; y >= 0; y--)
+                    file.write(pixels + rowSize * y, rowSize);
+                if (!file.good())
+                    result = GLFResult::OUTPUT_WRITE_ERROR;
+            }
+
+            if (pixels != NULL)
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            glDeleteBuffers(1, &pbo);
+
+            return result;
         }
 
 
         //==================================<<TEXT RENDERING>>==================================//
 
-        void _renderText(string text, float x, float y, float scale)
+        // adds the glyph quads of the text to the batch, all text of the frame is drawn by _flushText
+        void _renderText(const string& text, float x, float y, float scale)
         {
-            int vertLength = 16 * text.length();
-            int indLength = 6 * text.length();
-            if (text.length() > _MAX_STR_LEN)
+            Tracer::Scope trace("_renderText");
+
+            // the batch so far is moved into a larger buffer
+            if (_text.count + (int)text.length() > _text.capacity)
             {
-                vertLength = 16 * _MAX_STR_LEN;
-                indLength = 6 * _MAX_STR_LEN;
+                if (!_createTextBuffers(max(_text.capacity * 2, _text.count + (int)text.length())))
+                    return;
             }
 
-            unique_ptr<float> vertPtr{ new float[vertLength] };
-            float* vertices = vertPtr.get();
-            
-            unique_ptr<unsigned int> indPtr{ new unsigned int[indLength] };
-            unsigned int* indices = indPtr.get();
+            // the region is written again once the gpu has drawn its text from the earlier frame
+            GLsync& fence = _text.fences[_text.region];
+            if (_text.count == 0 && fence)
+            {
+                glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
 
-            int indIndex = 0;
-            int i = 0;
-            for (string::const_iterator c = text.begin(); c != text.end() && i < _MAX_STR_LEN; c++, indIndex += 4, i++)
+            // only the lines that have changed are laid out again
+            _TextKey key{ text, x, y, scale };
+            auto line = _textCache.lines.find(key);
+            if (line == _textCache.lines.end())
+                line = _textCache.lines.emplace(std::move(key), _TextLayout{ _layoutText(text, x, y, scale), 0 }).first;
+            line->second.used = _textCache.batch;
+
+            const vector<float>& vertices = line->second.vertices;
+            memcpy(_text.vertices + ((size_t)_text.region * _text.capacity + _text.count) * 16, vertices.data(), vertices.size() * sizeof(float));
+            _text.count += (int)text.length();
+        }
+
+        // glyph quads of the text, 16 floats for each character
+        vector<float> _layoutText(const string& text, float x, float y, float scale)
+        {
+            vector<float> layout(text.length() * 16);
+            float* vertices = layout.data();
+            for (char c : text)
             {
-                Character ch = _font[*c];
+                Character ch = _font[c];
 
                 float xPos = x + ch.bearing.x * scale;
                 float yPos = y - (ch.size.y - ch.bearing.y) * scale;
@@ -1168,61 +2970,132 @@ namespace GLFractal
                 *vertices++ = xPos + w; *vertices++ = yPos;     *vertices++ = (float)(ch.position.x + ch.size.x) / _font.width(); *vertices++ = (float)ch.position.y / _font.height();
                 *vertices++ = xPos + w; *vertices++ = yPos + h; *vertices++ = (float)(ch.position.x + ch.size.x) / _font.width(); *vertices++ = (float)(ch.position.y + ch.size.y) / _font.height();
 
-                *indices++ = indIndex + 0; *indices++ = indIndex + 1; *indices++ = indIndex + 3;
-                *indices++ = indIndex + 1; *indices++ = indIndex + 2; *indices++ = indIndex + 3;
-
                 x += (ch.advance >> 6) * scale;
             }
+            return layout;
+        }
+
+        // draws the batched text with a single draw call and moves on to the next region
+        void _flushText()
+        {
+            if (_text.count == 0)
+                return;
+
+            _drawText(_buffers.textVBO, _text.count, _text.region * _text.capacity * 4);
+            _endTextBatch();
+        }
+
+        // copies the batched text into its own buffer and draws it, the batch is drawn from there from now on
+        void _retainText(_RetainedText& text)
+        {
+            glDeleteBuffers(1, &text.vbo);
+            text.count = _text.count;
+            glCreateBuffers(1, &text.vbo);
+            glNamedBufferStorage(text.vbo, max(sizeof(float) * 16 * text.count, sizeof(float)), NULL, 0);
+            glCopyNamedBufferSubData(_buffers.textVBO, text.vbo, sizeof(float) * 16 * _text.region * _text.capacity, 0, sizeof(float) * 16 * text.count);
+            _endTextBatch();
+
+            _drawText(text.vbo, text.count, 0);
+        }
+
+        void _drawText(unsigned int vbo, int count, int baseVertex)
+        {
+            if (count == 0)
+                return;
 
             _fontShader.update();
             glBindVertexArray(_buffers.textVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, _buffers.textVBO);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(float) * vertLength, vertPtr.get());
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffers.textEBO);
-            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(unsigned int) * indLength, indPtr.get());
-            glVertexAttribPointer(0, vertLength, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-            glDrawElements(GL_TRIANGLES, indLength, GL_UNSIGNED_INT, 0);
+            if (vbo != _buffers.textVBO)
+                glVertexArrayVertexBuffer(_buffers.textVAO, 0, vbo, 0, 4 * sizeof(float));
+            {
+                Tracer::Scope trace("draw text");
+                glDrawElementsBaseVertex(GL_TRIANGLES, 6 * count, GL_UNSIGNED_INT, 0, baseVertex);
+            }
+            if (vbo != _buffers.textVBO)
+                glVertexArrayVertexBuffer(_buffers.textVAO, 0, _buffers.textVBO, 0, 4 * sizeof(float));
+        }
 
-            if (text.length() > _MAX_STR_LEN)
-                _renderText(text.substr(_MAX_STR_LEN, text.length() - _MAX_STR_LEN), x, y, scale);
+        // the region is left for the gpu and the lines that weren't drawn for a while are dropped
+        void _endTextBatch()
+        {
+            _text.fences[_text.region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            _text.region = (_text.region + 1) % _TEXT_REGIONS;
+            _text.count = 0;
+
+            if (++_textCache.batch % _TEXT_CACHE_AGE == 0)
+                erase_if(_textCache.lines, [](const auto& line) { return line.second.used < _textCache.batch - _TEXT_CACHE_AGE; });
         }
 
-        void _renderInfo(int fps)
+        void _renderInfo()
         {
             const float lm = _VIEW_WIDTH + 10;
             const float ls = lm + 10;
             float t = _VIEW_HEIGHT - 20;
 
-            string useDouble = _useDouble ? "yes" : "no";
+            string frame = "Fps: " + to_string((int)round(_pacer.fps()))
+                + "  Frame: " + Parser::toString(_pacer.frameTime() * 1000, 3)
+                + " / " + Parser::toString(_pacer.targetFrameTime() * 1000, 3) + " ms";
+            // milliseconds rounded to hundredths
+            auto ms = [](double time) { return Parser::toString(round(time * 1e5) / 100, 9); };
+
+            Precision active = _activePrecision();
+            string precision = active == Precision::DOUBLE ? "double"
+                : active == Precision::DF64 ? "df64"
+                : "float";
+            if (_precision == Precision::AUTO)
+                precision = "auto (" + precision + ")";
+            string backend = _backend == Backend::CPU
+                ? "cpu (" + to_string(_cpu.threadCount()) + " threads, " + CpuRenderer::instructionSet() + ")"
+                : "gpu";
+
+            // min / avg / p99 gpu time of the passes, under the frame time so that they stay above the selector
+            _renderText(frame, lm, t, _spacing.scaleM);
+            for (int i = 0; i < _gpuTimer.passCount(); i++)
+            {
+                GpuTimer::Stats times = _gpuTimer.stats(i);
+                string info = times.samples == 0 ? "-"
+                    : ms(times.min) + " / " + ms(times.average) + " / " + ms(times.p99) + " ms";
+                _renderText("GPU " + _gpuTimer.name(i) + ": " + info, ls, t -= i == 0 ? _spacing.extended : _spacing.normal, _spacing.scaleS);
+            }
 
             switch (_frac)
             {
             case Fractal::HELP:
-                _renderText("Fps: " + to_string(fps), lm, t, _spacing.scaleM);
-
                 _renderText("Fractal: Help page", lm, t -= _spacing.full, _spacing.scaleM);
                 break;
             case Fractal::MANDELBROT:
-                _renderText("Fps: " + to_string(fps), lm, t, _spacing.scaleM);
-
                 _renderText("Fractal: Mandelbrot set", lm, t -= _spacing.full, _spacing.scaleM);
 
                 _renderText("Main:", lm, t -= _spacing.full, _spacing.scaleM);
-                _renderText("Iterations: " + to_string(_iterations), ls, t -= _spacing.extended, _spacing.scaleS);
+                _renderText("Iterations: " + _iterationsInfo(_iterations), ls, t -= _spacing.extended, _spacing.scaleS);
                 _renderText("Color count: " + to_string((int)_colorCount), ls, t -= _spacing.normal, _spacing.scaleS);
-                _renderText("Use double: " + useDouble, ls, t -= _spacing.normal, _spacing.scaleS);
+                _renderText("Precision: " + precision, ls, t -= _spacing.normal, _spacing.scaleS);
+                _renderText("Backend: " + backend, ls, t -= _spacing.normal, _spacing.scaleS);
+                if (_antialias.samples > 1 && _backend == Backend::GPU)
+                    _renderText("Antialiasing: " + _antialiasInfo(), ls, t -= _spacing.normal, _spacing.scaleS);
+                if (_backend == Backend::CPU && _subdivision)
+                    _renderText("Skipped by subdivision: " + to_string((int)round(_cpu.fillRatio() * 100)) + " %", ls, t -= _spacing.normal, _spacing.scaleS);
                 _renderText("Scale: " + Parser::toString(_scale / 4), ls, t -= _spacing.normal, _spacing.scaleS);
                 _renderText("Center: " + Parser::toString(-_center.x) + " + " + Parser::toString(-_center.y) + "i", ls, t -= _spacing.normal, _spacing.scaleS);
+                if (_usePerturbation())
+                {
+                    _renderText("Perturbation: " + to_string(_orbit.points.size() / 2) + " orbit points, "
+                        + (_perturbationDouble() ? "double" : "float"), ls, t -= _spacing.normal, _spacing.scaleS);
+                    _renderText("Skipped by series: " + to_string(_orbit.skip) + " iterations", ls, t -= _spacing.normal, _spacing.scaleS);
+                }
                 break;
             case Fractal::JULIA:
-                _renderText("Fps: " + to_string(fps), lm, t, _spacing.scaleM);
-
                 _renderText("Fractal: Julia set", lm, t -= _spacing.full, _spacing.scaleM);
 
                 _renderText("Main:", lm, t -= _spacing.full, _spacing.scaleM);
-                _renderText("Iterations: " + to_string(_iterations), ls, t -= _spacing.extended, _spacing.scaleS);
+                _renderText("Iterations: " + _iterationsInfo(_iterations), ls, t -= _spacing.extended, _spacing.scaleS);
                 _renderText("Color count: " + to_string((int)_colorCount), ls, t -= _spacing.normal, _spacing.scaleS);
-                _renderText("Use double: " + useDouble, ls, t -= _spacing.normal, _spacing.scaleS);
+                _renderText("Precision: " + precision, ls, t -= _spacing.normal, _spacing.scaleS);
+                _renderText("Backend: " + backend, ls, t -= _spacing.normal, _spacing.scaleS);
+                if (_antialias.samples > 1 && _backend == Backend::GPU)
+                    _renderText("Antialiasing: " + _antialiasInfo(), ls, t -= _spacing.normal, _spacing.scaleS);
+                if (_backend == Backend::CPU && _subdivision)
+                    _renderText("Skipped by subdivision: " + to_string((int)round(_cpu.fillRatio() * 100)) + " %", ls, t -= _spacing.normal, _spacing.scaleS);
                 _renderText("Scale: " + Parser::toString(_scale / 4), ls, t -= _spacing.normal, _spacing.scaleS);
                 _renderText("Center: " + Parser::toString(-_center.x) + " + " + Parser::toString(-_center.y) + "i", ls, t -= _spacing.normal, _spacing.scaleS);
                 _renderText("Number: " + to_string(_constants[0].x) + " + " + to_string(_constants[0].y) + "i", ls, t -= _spacing.normal, _spacing.scaleS);
@@ -1234,13 +3107,14 @@ namespace GLFractal
                 _renderText("Center: " + Parser::toString(-_selCenter.x) + " + " + Parser::toString(-_selCenter.y) + "i", ls, t -= _spacing.normal, _spacing.scaleS);
                 break;
             case Fractal::NEWTON:
-                _renderText("Fps: " + to_string(fps), lm, t, _spacing.scaleM);
-
                 _renderText("Fractal: Newton fractal", lm, t -= _spacing.full, _spacing.scaleM);
 
                 _renderText("Main:", lm, t -= _spacing.full, _spacing.scaleM);
-                _renderText("Iterations: " + to_string(_iterations / 10), ls, t -= _spacing.extended, _spacing.scaleS);
-                _renderText("Use double: " + useDouble, ls, t -= _spacing.normal, _spacing.scaleS);
+                _renderText("Iterations: " + _iterationsInfo(_iterations / 10), ls, t -= _spacing.extended, _spacing.scaleS);
+                _renderText("Precision: " + precision, ls, t -= _spacing.normal, _spacing.scaleS);
+                _renderText("Backend: " + backend, ls, t -= _spacing.normal, _spacing.scaleS);
+                if (_antialias.samples > 1 && _backend == Backend::GPU)
+                    _renderText("Antialiasing: " + _antialiasInfo(), ls, t -= _spacing.normal, _spacing.scaleS);
                 _renderText("Scale: " + Parser::toString(_scale / 4), ls, t -= _spacing.normal, _spacing.scaleS);
                 _renderText("Center: " + Parser::toString(-_center.x) + " + " + Parser::toString(-_center.y) + "i", ls, t -= _spacing.normal, _spacing.scaleS);
                 _renderText("Number of roots: " + to_string(_rootCount), ls, t -= _spacing.normal, _spacing.scaleS);
@@ -1248,13 +3122,14 @@ namespace GLFractal
                     _renderText(" " + Parser::toString(_roots[i].x) + ", " + Parser::toString(_roots[i].y) + "i", ls, t -= _spacing.normal, _spacing.scaleS);
                 break;
             case Fractal::NOVA:
-                _renderText("Fps: " + to_string(fps), lm, t, _spacing.scaleM);
-
                 _renderText("Fractal: Nova fractal", lm, t -= _spacing.full, _spacing.scaleM);
 
                 _renderText("Main:", lm, t -= _spacing.full, _spacing.scaleM);
-                _renderText("Iterations: " + to_string(_iterations / 10), ls, t -= _spacing.extended, _spacing.scaleS);
-                _renderText("Use double: " + useDouble, ls, t -= _spacing.normal, _spacing.scaleS);
+                _renderText("Iterations: " + _iterationsInfo(_iterations / 10), ls, t -= _spacing.extended, _spacing.scaleS);
+                _renderText("Precision: " + precision, ls, t -= _spacing.normal, _spacing.scaleS);
+                _renderText("Backend: " + backend, ls, t -= _spacing.normal, _spacing.scaleS);
+                if (_antialias.samples > 1 && _backend == Backend::GPU)
+                    _renderText("Antialiasing: " + _antialiasInfo(), ls, t -= _spacing.normal, _spacing.scaleS);
                 _renderText("Scale: " + Parser::toString(_scale / 4), ls, t -= _spacing.normal, _spacing.scaleS);
                 _renderText("Center: " + Parser::toString(-_center.x) + " + " + Parser::toString(-_center.y) + "i", ls, t -= _spacing.normal, _spacing.scaleS);
                 _renderText("Adder constant: " + to_string(_constants[0].x) + " + " + to_string(_constants[0].y) + "i", ls, t -= _spacing.normal, _spacing.scaleS);
@@ -1269,15 +3144,41 @@ namespace GLFractal
                 _renderText("Center: " + Parser::toString(-_selCenter.x) + " + " + Parser::toString(-_selCenter.y) + "i", ls, t -= _spacing.normal, _spacing.scaleS);
                 break;
             default:
-                _renderText("Fps: " + to_string(fps), lm, t, _spacing.scaleM);
-
                 _renderText("Fractal: Unknown", lm, t -= _spacing.full, _spacing.scaleM);
                 break;
             }
+
+            _flushText();
+        }
+
+        string _iterationsInfo(int iterations)
+        {
+            // shows how far is the progressive rendering
+            if (_progress.start >= _progress.total)
+                return to_string(iterations);
+            return to_string(_progress.start) + " / " + to_string(iterations);
+        }
+
+        string _antialiasInfo()
+        {
+            // shows how many of the pixels are refined and how far is the sampling
+            string info = to_string(_antialias.samples) + " samples";
+            if (!_antialias.marked)
+                return info;
+            info += " on " + to_string((int)round(_antialias.refined * 100)) + " % of pixels";
+            if (_antialias.sample < _antialias.samples)
+                info += " (" + to_string(_antialias.sample) + " done)";
+            return info;
         }
 
         void _renderHelp()
         {
+            if (_helpText.vbo != 0)
+            {
+                _drawText(_helpText.vbo, _helpText.count, 0);
+                return;
+            }
+
             const float c1m = 10;
             const float c1s = c1m + 10;
             const float c2m = _VIEW_WIDTH / 2 + 10;
@@ -1342,7 +3243,8 @@ namespace GLFractal
             _renderText("2048 : Alt + O", c2s, t -= _spacing.normal, _spacing.scaleS);
 
             _renderText("Render:", c2m, t -= _spacing.full, _spacing.scaleM);
-            _renderText("toggle double : Tab", c2s, t -= _spacing.extended, _spacing.scaleS);
+            _renderText("cycle precision    : Tab", c2s, t -= _spacing.extended, _spacing.scaleS);
+            _renderText("cycle antialiasing : A", c2s, t -= _spacing.normal, _spacing.scaleS);
 
             _renderText("Reset (space for selector):", c2m, t -= _spacing.full, _spacing.scaleM);
             _renderText("zoom and center  : R", c2s, t -= _spacing.extended, _spacing.scaleS);
@@ -1353,6 +3255,8 @@ namespace GLFractal
             _renderText("Newton fractal:", c2m, t -= _spacing.full, _spacing.scaleM);
             _renderText("add/remove point : Shift + RMB", c2s, t -= _spacing.extended, _spacing.scaleS);
             _renderText("move point       : Shift + LMB", c2s, t -= _spacing.normal, _spacing.scaleS);
+
+            _retainText(_helpText);
         }
     }
 
@@ -1364,7 +3268,7 @@ namespace GLFractal
         _initialSettings = config;
 
         _scale      = config.scale;
-        _center     = config.center;
+        _resetCenter();
         _iterations = config.iterations;
         _color      = config.color;
 
@@ -1379,12 +3283,35 @@ namespace GLFractal
         _selColorCount = config.selColorCount;
 
         _frac      = config.fractal;
-        _useDouble = config.useDouble;
+        _precision = config.precision;
+        // double precision used to pick the debug page before it had its own key
+        _debugPage = config.fractal == Fractal::HELP && config.precision == Precision::DOUBLE;
+        _periodicityTolerance = config.periodicityTolerance;
 
         _fontSize = config.fontSize;
         _textColor = config.textColor;
 
-        _fpsLimit = config.fpsLimit;
+        _pacer = FramePacer(config.fpsLimit, config.inputRate);
+
+        if (config.headless)
+        {
+            _mainWidth = config.width;
+            _mainHeight = config.height;
+        }
+        _progress.slice = config.iterationSlice;
+
+        _resolution.targetFrameTime = config.interactionFps > 0 ? 1.0 / config.interactionFps : 0;
+        _resolution.idleTime = config.idleTime;
+        _antialias.samples = max(config.antialiasing, 1);
+
+        // images have the full size of the main view
+        _cache = ViewCache(_mainWidth, _mainHeight, (size_t)config.cacheGpuMemory << 20, (size_t)config.cacheHostMemory << 20);
+
+        _backend = config.backend;
+        _subdivision = config.subdivision;
+        _tiles.enabled = config.tiles;
+        if (_backend == Backend::CPU)
+            _cpu = CpuRenderer(_mainWidth, _mainHeight, config.threadCount);
 
         if (config.rootCount >= 0)
         {
@@ -1398,12 +3325,27 @@ namespace GLFractal
         if ((result = _init()) != GLFResult::OK)
             return result;
 
+        glfwSwapInterval(config.vsync ? 1 : 0);
+
         glClearColor(config.backgroundColor.x, config.backgroundColor.y, config.backgroundColor.z, 1.0f);
 
         if ((result = _initShaders()) != GLFResult::OK)
             return result;
         if ((result = _initBuffers()) != GLFResult::OK)
             return result;
+        if ((result = _initViews()) != GLFResult::OK)
+            return result;
+        if ((result = _initProgress()) != GLFResult::OK)
+            return result;
+        if ((result = _initTiles()) != GLFResult::OK)
+            return result;
+
+        // names follow the order of _GpuPass, a few seconds of frames are kept
+        _gpuTimer = GpuTimer({ "Main", "Selector", "Text" }, 240);
+        _gpuTimesPath = config.gpuTimesPath;
+        _tracePath = config.tracePath;
+        if (!_tracePath.empty())
+            Tracer::start(_TRACE_EVENTS);
         if ((result = _loadTexture(config.gradient)) != GLFResult::OK)
             return result;
         if ((result = _loadFont(config.fontPath)) != GLFResult::OK)
@@ -1414,90 +3356,127 @@ namespace GLFractal
 
     GLFResult mainloop()
     {
-        double lastTime = glfwGetTime();
+        GLFResult result{ GLFResult::OK };
         while (!glfwWindowShouldClose(_window))
         {
             // user input
             _processInput(_window);
 
-            double newTime = glfwGetTime();
-            double deltaTime = newTime - lastTime;
-            double fps = 1.0 / deltaTime;
-            if (fps > _fpsLimit)
-                continue;
-
-            lastTime = newTime;
+            // input has settled, the image with lower resolution is rendered again in full resolution
+            if (_resolution.reduction > 1 && !_interacting())
+            {
+                _progress.start = 0;
+                _dirty |= _RenderChange::MAIN;
+            }
 
-            // clearing display
-            glClear(GL_COLOR_BUFFER_BIT);
+            // nothing has changed, sleep until there is new input (or until the input settles)
+            if (_dirty == _RenderChange::NONE)
+            {
+                if (_resolution.reduction > 1)
+                    glfwWaitEventsTimeout(max(_resolution.lastChange + _resolution.idleTime - glfwGetTime(), 0.0));
+                else
+                    glfwWaitEvents();
+                continue;
+            }
 
-            //glBindTexture(GL_TEXTURE_2D, _buffers.gradientTexture);
-            glBindVertexArray(_buffers.mainVAO);
+            // sleep until the frame deadline, but keep sampling the input
+            double wait = _pacer.timeToFrame();
+            if (wait > 0)
+            {
+                glfwWaitEventsTimeout(_pacer.inputInterval() > 0 ? min(wait, _pacer.inputInterval()) : wait);
+                continue;
+            }
 
-            // choosing fractal to render
-            switch (_fractal())
+            _pacer.beginFrame();
+            Tracer::Scope frame("frame");
+
+            // rendering only the views that have changed
+            bool interactive = (_dirty & (_RenderChange::MAIN | _RenderChange::SHIFT)) != _RenderChange::NONE && _interacting();
+            bool timeMain = (_dirty & (_RenderChange::MAIN | _RenderChange::SHIFT | _RenderChange::COLOR | _RenderChange::ANTIALIAS)) != _RenderChange::NONE;
+            if (timeMain)
+                _gpuTimer.begin((int)_GpuPass::MAIN);
+            if ((_dirty & (_RenderChange::MAIN | _RenderChange::SHIFT)) != _RenderChange::NONE)
+                result = _renderMain();
+            // palette has changed, but the iterations can be reused
+            else if ((_dirty & _RenderChange::COLOR) != _RenderChange::NONE && _frac != Fractal::HELP)
+                _colorizeMain();
+            else if ((_dirty & _RenderChange::ANTIALIAS) != _RenderChange::NONE)
+                result = _antialiasMain();
+            if (timeMain)
+                _gpuTimer.end();
+            if (result != GLFResult::OK)
+                return result;
+
+            if ((_dirty & _RenderChange::SELECTOR) != _RenderChange::NONE)
             {
-            case _Fractal::MANDELBROT_F:
-                _fractals.mandelbrotF.update();
-                break;
-            case _Fractal::MANDELBROT_D:
-                _fractals.mandelbrotD.update();
-                break;
-            case _Fractal::JULIA_F:
-                _fractals.juliaF.update();
-                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(_buffers.selVAO);
-                _fractals.mandelbrotSelector.update();
-                break;
-            case _Fractal::JULIA_D:
-                _fractals.juliaD.update();
-                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(_buffers.selVAO);
-                _fractals.mandelbrotSelector.update();
-                break;
-            case _Fractal::HELP_F:
-                _renderHelp();
-                break;
-            case _Fractal::HELP_D:
-                _fractals.debug.update();
-                break;
-            case _Fractal::NEWTON_F:
-                _fractals.newtonCoefF.update();
-                break;
-            case _Fractal::NEWTON_D:
-                _fractals.newtonCoefD.update();
-                break;
-            case _Fractal::NOVA_F:
-                _fractals.novaF.update();
-                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(_buffers.selVAO);
-                _constantCount = 2;
-                _fractals.selector.update();
-                break;
-            case _Fractal::NOVA_D:
-                _fractals.novaD.update();
-                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(_buffers.selVAO);
-                _constantCount = 2;
-                _fractals.selector.update();
-                break;
-            default:
-                return GLFResult::INVALID_FRACTAL;
+                _gpuTimer.begin((int)_GpuPass::SELECTOR);
+                result = _renderSelector();
+                _gpuTimer.end();
+                if (result != GLFResult::OK)
+                    return result;
             }
+            _dirty = _RenderChange::NONE;
 
-            // rendering image
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+            // main view is not fully iterated, continue in the next frame
+            if (_progress.start < _progress.total)
+                _dirty |= _RenderChange::MAIN;
+            // finished view is antialiased over the next frames
+            else if (_antialiasPending())
+                _dirty |= _RenderChange::ANTIALIAS;
 
-            _renderInfo((int)round(fps));
+            _composite();
 
             // showing image
-            glfwSwapBuffers(_window);
+            {
+                Tracer::Scope trace("glfwSwapBuffers");
+                glfwSwapBuffers(_window);
+            }
+
+            _pacer.endFrame();
+            _gpuTimer.collect();
+
+            // frames of the changing view are kept at the target frame time
+            if (interactive)
+                _adaptResolution(_pacer.frameTime());
 
             // updating user input
             glfwPollEvents();
         }
 
-        return GLFResult::OK;
+        return _saveMeasurements();
+    }
+
+    GLFResult renderToFile(string path)
+    {
+        GLFResult result{ GLFResult::OK };
+
+        // there is no frame limit, all the slices are rendered at once
+        do
+        {
+            _gpuTimer.begin((int)_GpuPass::MAIN);
+            result = _renderMain();
+            _gpuTimer.end();
+            if (result != GLFResult::OK)
+                return result;
+            // submitting each slice separately so that no single batch runs too long
+            glFlush();
+            _gpuTimer.collect();
+        } while (_progress.start < _progress.total);
+
+        while (_antialiasPending())
+        {
+            _gpuTimer.begin((int)_GpuPass::MAIN);
+            result = _antialiasMain();
+            _gpuTimer.end();
+            if (result != GLFResult::OK)
+                return result;
+            glFlush();
+            _gpuTimer.collect();
+        }
+
+        if ((result = _saveView(_views.main, path)) != GLFResult::OK)
+            return result;
+        return _saveMeasurements();
     }
 
     GLFResult terminate()
@@ -1513,24 +3492,71 @@ namespace GLFractal
         glDeleteVertexArrays(1, &_buffers.textVAO);
         glDeleteBuffers(1, &_buffers.textVBO);
         glDeleteBuffers(1, &_buffers.textEBO);
+        for (GLsync fence : _text.fences)
+            glDeleteSync(fence);
+        glDeleteBuffers(1, &_helpText.vbo);
+
+        glDeleteBuffers(1, &_buffers.parameterUBO);
+        glDeleteBuffers(1, &_buffers.samplingUBO);
+        glDeleteBuffers(1, &_antialias.counter);
+        glDeleteBuffers(1, &_orbit.bufferF);
+        glDeleteBuffers(1, &_orbit.bufferD);
 
         glDeleteTextures(1, &_buffers.gradientTexture);
         glDeleteTextures(1, &_buffers.fontTexture);
 
+        glDeleteFramebuffers(1, &_views.main.fbo);
+        glDeleteTextures(1, &_views.main.texture);
+        glDeleteFramebuffers(1, &_views.selector.fbo);
+        glDeleteTextures(1, &_views.selector.texture);
+
+        glDeleteTextures(1, &_progress.zState);
+        glDeleteTextures(1, &_progress.iterState);
+        glDeleteTextures(1, &_progress.refState);
+        glDeleteTextures(1, &_progress.zSpare);
+        glDeleteTextures(1, &_progress.iterSpare);
+        glDeleteTextures(1, &_progress.refSpare);
+        glDeleteFramebuffers(1, &_preview.fbo);
+        glDeleteTextures(1, &_preview.texture);
+        glDeleteFramebuffers(1, &_antialias.fbo);
+        glDeleteTextures(1, &_antialias.texture);
+        glDeleteRenderbuffers(1, &_antialias.stencil);
+
         _fractals.mandelbrotF.free();
         _fractals.mandelbrotD.free();
+        _fractals.mandelbrotDF.free();
+        _fractals.perturbationF.free();
+        _fractals.perturbationD.free();
         _fractals.mandelbrotSelector.free();
         _fractals.juliaF.free();
         _fractals.juliaD.free();
+        _fractals.juliaDF.free();
         _fractals.newtonCoefF.free();
         _fractals.newtonCoefD.free();
+        _fractals.newtonCoefDF.free();
         _fractals.novaF.free();
         _fractals.novaD.free();
+        _fractals.novaDF.free();
+        _fractals.colorize.free();
+        _fractals.edges.free();
+        _fractals.antialias.free();
         _fractals.selector.free();
+        _fractals.markers.free();
+        _gpuTimer.free();
+        Tracer::free();
+        if (_tiles.enabled)
+        {
+            for (auto& [fragment, kernel] : _tiles.kernels)
+                kernel.free();
+            glDeleteBuffers(1, &_tiles.current);
+            glDeleteBuffers(1, &_tiles.next);
+        }
         _fractals.debug.free();
 
         _fontShader.free();
 
+        _cache.clear();
+
         glfwTerminate();
 
         return GLFResult::OK;
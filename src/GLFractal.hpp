@@ -2,6 +2,7 @@
 
 #include "Vectors.hpp"
 #include "Gradient.hpp"
+#include "FixedPoint.hpp"
 
 /// <summary>
 /// Contains functions that run the Fractal window
@@ -20,6 +21,28 @@ namespace GLFractal
 		NOVA = 0b100,
 	};
 
+	/// <summary>
+	/// Arithmetic used to iterate the main view
+	/// </summary>
+	enum class Precision
+	{
+		FLOAT = 0,
+		DOUBLE,
+		// pairs of floats with about 48 bits of mantissa, on most gpus much faster than double
+		DF64,
+		// cheapest of the above that still resolves single pixels at the current zoom
+		AUTO,
+	};
+
+	/// <summary>
+	/// Where the main view is iterated
+	/// </summary>
+	enum class Backend
+	{
+		GPU = 0,
+		CPU,
+	};
+
 	/// <summary>
 	/// Error codes
 	/// </summary>
@@ -35,6 +58,10 @@ namespace GLFractal
 		FREETYPE_LOAD_ERROR,
 		FONT_LOAD_ERROR,
 		SOME_CHARACTERS_MISSING,
+		FRAMEBUFFER_INIT_ERROR,
+		OUTPUT_WRITE_ERROR,
+		TIMES_WRITE_ERROR,
+		TRACE_WRITE_ERROR,
 	};
 
 	/// <summary>
@@ -53,6 +80,13 @@ namespace GLFractal
 		/// </summary>
 		DVec2 center{ 0.0, 0.0 };
 		/// <summary>
+		/// Center with more precision than double for deep zooms (negated like center), used instead of center when preciseCenter is set
+		/// default: not set
+		/// </summary>
+		bool preciseCenter{ false };
+		FixedPoint preciseCenterX;
+		FixedPoint preciseCenterY;
+		/// <summary>
 		/// How many iterations should be done for each pixel to determine its color (in main view)
 		/// default: 1000
 		/// </summary>
@@ -100,10 +134,10 @@ namespace GLFractal
 		/// </summary>
 		Fractal fractal{ Fractal::MANDELBROT };
 		/// <summary>
-		/// Determines whether the main view should use double floating point arithmetic or not (true will very negativly affect performance on most GPUs)
-		/// default: false
+		/// Arithmetic used by the main view (DOUBLE will very negativly affect performance on most GPUs, DF64 less so)
+		/// default: AUTO
 		/// </summary>
-		bool useDouble{ false };
+		Precision precision{ Precision::AUTO };
 
 		/// <summary>
 		/// Background color of the window
@@ -139,6 +173,120 @@ namespace GLFractal
 		/// </summary>
 		double fpsLimit = 10000.0;
 
+		/// <summary>
+		/// Determines whether the buffer swaps should be synchronized with the monitor refresh rate
+		/// default: false
+		/// </summary>
+		bool vsync = false;
+
+		/// <summary>
+		/// How many times per second is the input sampled while waiting for the next frame
+		/// default: 240
+		/// </summary>
+		double inputRate = 240.0;
+
+		/// <summary>
+		/// How many iterations are done for each pixel in one frame, deep iterations are spread over multiple frames (0 does all iterations in one frame)
+		/// default: 1000
+		/// </summary>
+		int iterationSlice = 1000;
+
+		/// <summary>
+		/// Frame rate kept while the main view is changing, the changing view is rendered at lower resolution
+		/// when its frames take longer (0 always renders full resolution)
+		/// default: 60
+		/// </summary>
+		double interactionFps = 60.0;
+
+		/// <summary>
+		/// Time in seconds without changes after which the main view is rendered again in full resolution
+		/// default: 0.25
+		/// </summary>
+		double idleTime = 0.25;
+
+		/// <summary>
+		/// Samples of the pixels on edges of the finished main view, the pixels whose neighbors have different results
+		/// or iterations are rendered again as the average of samples moved by less than a pixel (1 disables antialiasing)
+		/// default: 1
+		/// </summary>
+		int antialiasing = 1;
+
+		/// <summary>
+		/// Megabytes of GPU memory for finished images of the main view, revisited views are copied instead of
+		/// iterated again, the least recently used images are moved to the RAM (0 keeps no images on the GPU)
+		/// default: 128
+		/// </summary>
+		int cacheGpuMemory = 128;
+
+		/// <summary>
+		/// Megabytes of RAM for the images that don't fit into the GPU memory of the cache (0 keeps no images in the RAM)
+		/// default: 512
+		/// </summary>
+		int cacheHostMemory = 512;
+
+		/// <summary>
+		/// Mandelbrot and julia points whose z comes closer than this to an earlier z are taken as inside the set,
+		/// the distance is relative to the distance between pixels (0 disables periodicity checking)
+		/// default: 0.001
+		/// </summary>
+		double periodicityTolerance = 0.001;
+
+		/// <summary>
+		/// Renders only the main view into an image file, the window is hidden
+		/// default: false
+		/// </summary>
+		bool headless = false;
+
+		/// <summary>
+		/// Size of the rendered image in headless mode
+		/// default: 1000 x 1000
+		/// </summary>
+		int width = 1000;
+		int height = 1000;
+
+		/// <summary>
+		/// Path to the image (binary ppm) rendered in headless mode
+		/// default: "fractal.ppm"
+		/// </summary>
+		string outputPath{ "fractal.ppm" };
+
+		/// <summary>
+		/// CSV file the GPU times of the render passes are written to when the program ends (empty doesn't write them)
+		/// default: ""
+		/// </summary>
+		string gpuTimesPath{};
+
+		/// <summary>
+		/// JSON file the timeline of the frames is written to as Chrome trace events when the program ends (empty doesn't record it)
+		/// default: ""
+		/// </summary>
+		string tracePath{};
+
+		/// <summary>
+		/// Determines whether the main view is iterated by the fragment shaders or by the SIMD kernels on the CPU
+		/// default: GPU
+		/// </summary>
+		Backend backend{ Backend::GPU };
+
+		/// <summary>
+		/// Number of threads used by the CPU backend (0 uses all cores)
+		/// default: 0
+		/// </summary>
+		int threadCount = 0;
+
+		/// <summary>
+		/// Determines whether the CPU backend fills mandelbrot and julia rectangles with uniform border without iterating them
+		/// default: true
+		/// </summary>
+		bool subdivision = true;
+
+		/// <summary>
+		/// Determines whether the GPU backend iterates the main view with compute shaders in tiles of 8x8 pixels,
+		/// each slice dispatches only the tiles that still have unfinished pixels (false uses the fragment shaders)
+		/// default: true
+		/// </summary>
+		bool tiles = true;
+
 		/// <summary>
 		/// Sets the number of roots negative number leaves the default
 		/// default: -1
@@ -164,6 +312,12 @@ namespace GLFractal
 	/// <returns>Error code (OK = 0)</returns>
 	GLFResult mainloop();
 	/// <summary>
+	/// Renders the main view with all iterations and saves it as binary ppm image (used in headless mode)
+	/// </summary>
+	/// <param name="path">Path to the image</param>
+	/// <returns>Error code (OK = 0)</returns>
+	GLFResult renderToFile(string path);
+	/// <summary>
 	/// Deletes all resources
 	/// </summary>
 	/// <returns>Error code (OK = 0)</returns>
@@ -0,0 +1,131 @@
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <fstream>
+
+#include "GpuTimer.hpp"
+
+using std::sort, std::min, std::max, std::ofstream, std::endl;
+
+// queries of each pass, the result of a query has this many frames to arrive before the pass is skipped
+const int _QUERIES_PER_PASS = 4;
+
+GpuTimer::GpuTimer() : _active(-1) {}
+
+GpuTimer::GpuTimer(vector<string> passes, int historySize) : _active(-1)
+{
+    for (string& name : passes)
+    {
+        _Pass pass;
+        pass.name = name;
+        pass.queries.resize(_QUERIES_PER_PASS);
+        pass.pending.resize(_QUERIES_PER_PASS, false);
+        pass.history.resize(max(historySize, 1));
+        glCreateQueries(GL_TIME_ELAPSED, _QUERIES_PER_PASS, pass.queries.data());
+        _passes.push_back(pass);
+    }
+}
+
+void GpuTimer::begin(int pass)
+{
+    _Pass& timed = _passes[pass];
+    if (timed.pending[timed.nextQuery])
+        return;
+
+    glBeginQuery(GL_TIME_ELAPSED, timed.queries[timed.nextQuery]);
+    _active = pass;
+}
+
+void GpuTimer::end()
+{
+    if (_active < 0)
+        return;
+
+    _Pass& timed = _passes[_active];
+    glEndQuery(GL_TIME_ELAPSED);
+    timed.pending[timed.nextQuery] = true;
+    timed.nextQuery = (timed.nextQuery + 1) % _QUERIES_PER_PASS;
+    _active = -1;
+}
+
+void GpuTimer::collect(bool wait)
+{
+    for (_Pass& pass : _passes)
+    {
+        // the oldest query is read first so that the times are kept in order
+        for (int i = 0; i < _QUERIES_PER_PASS; i++)
+        {
+            int query = (pass.nextQuery + i) % _QUERIES_PER_PASS;
+            if (!pass.pending[query])
+                continue;
+
+            int available = GL_TRUE;
+            if (!wait)
+                glGetQueryObjectiv(pass.queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+
+            GLuint64 time;
+            glGetQueryObjectui64v(pass.queries[query], GL_QUERY_RESULT, &time);
+            pass.pending[query] = false;
+
+            pass.history[pass.nextTime] = time * 1e-9;
+            pass.nextTime = (pass.nextTime + 1) % (int)pass.history.size();
+            pass.timeCount = min(pass.timeCount + 1, (int)pass.history.size());
+        }
+    }
+}
+
+GpuTimer::Stats GpuTimer::stats(int pass)
+{
+    const _Pass& timed = _passes[pass];
+    Stats stats;
+    if (timed.timeCount == 0)
+        return stats;
+
+    vector<double> times(timed.history.begin(), timed.history.begin() + timed.timeCount);
+    sort(times.begin(), times.end());
+
+    double sum = 0;
+    for (double time : times)
+        sum += time;
+
+    stats.min = times.front();
+    stats.average = sum / times.size();
+    stats.p99 = times[min((size_t)(times.size() * 0.99), times.size() - 1)];
+    stats.samples = (int)times.size();
+    return stats;
+}
+
+int GpuTimer::passCount()
+{
+    return (int)_passes.size();
+}
+
+const string& GpuTimer::name(int pass)
+{
+    return _passes[pass].name;
+}
+
+bool GpuTimer::save(const string& path)
+{
+    ofstream file(path);
+    if (!file.is_open())
+        return false;
+
+    file << "pass,min ms,average ms,p99 ms,samples" << endl;
+    for (int i = 0; i < passCount(); i++)
+    {
+        Stats times = stats(i);
+        file << _passes[i].name << "," << times.min * 1000 << "," << times.average * 1000 << ","
+            << times.p99 * 1000 << "," << times.samples << endl;
+    }
+    return file.good();
+}
+
+void GpuTimer::free()
+{
+    for (_Pass& pass : _passes)
+        glDeleteQueries((int)pass.queries.size(), pass.queries.data());
+    _passes.clear();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <string>
+
+using std::vector, std::string;
+
+/// <summary>
+/// Measures how long the render passes take on the GPU with timer queries. Each pass has a ring of queries
+/// whose results are read once they are available, so measuring never waits for the GPU
+/// </summary>
+class GpuTimer
+{
+public:
+    /// <summary>
+    /// Times of one pass over the last frames
+    /// </summary>
+    struct Stats
+    {
+        // times in seconds
+        double min = 0;
+        double average = 0;
+        double p99 = 0;
+        // number of times the statistics are from
+        int samples = 0;
+    };
+
+    /// <summary>
+    /// Creates timer with no passes
+    /// </summary>
+    GpuTimer();
+    /// <summary>
+    /// Creates timer for the given passes (needs the OpenGL context)
+    /// </summary>
+    /// <param name="passes">Names of the passes, passes are identified by their index</param>
+    /// <param name="historySize">Number of last times kept for each pass</param>
+    GpuTimer(vector<string> passes, int historySize);
+    /// <summary>
+    /// Starts measuring the pass, the pass is skipped when all of its queries are still waiting for results
+    /// </summary>
+    /// <param name="pass">Index of the pass</param>
+    void begin(int pass);
+    /// <summary>
+    /// Stops measuring the pass started by 'begin', passes can't overlap
+    /// </summary>
+    void end();
+    /// <summary>
+    /// Reads the results of the queries that are available
+    /// </summary>
+    /// <param name="wait">Waits for all the results</param>
+    void collect(bool wait = false);
+    /// <summary>
+    /// Gets the statistics of the kept times of the pass
+    /// </summary>
+    /// <param name="pass">Index of the pass</param>
+    /// <returns>Statistics of the pass</returns>
+    Stats stats(int pass);
+    /// <summary>
+    /// Gets the number of passes
+    /// </summary>
+    /// <returns>Number of passes</returns>
+    int passCount();
+    /// <summary>
+    /// Gets the name of the pass
+    /// </summary>
+    /// <param name="pass">Index of the pass</param>
+    /// <returns>Name of the pass</returns>
+    const string& name(int pass);
+    /// <summary>
+    /// Writes the statistics of all passes as CSV
+    /// </summary>
+    /// <param name="path">Path to the file</param>
+    /// <returns>True if the file was written</returns>
+    bool save(const string& path);
+    /// <summary>
+    /// Deletes the queries
+    /// </summary>
+    void free();
+private:
+    struct _Pass
+    {
+        string name;
+        vector<unsigned int> queries;
+        // the query was ended and its result wasn't read yet
+        vector<bool> pending;
+        int nextQuery = 0;
+
+        // ring of the last times in seconds
+        vector<double> history;
+        int nextTime = 0;
+        int timeCount = 0;
+    };
+
+    vector<_Pass> _passes;
+    // pass that is being measured (-1 = none)
+    int _active;
+};
@@ -51,6 +51,16 @@ int main(int argc, char** args)
                 return EXIT_FAILURE;
             }
             config.center = DVec2{ -x, -y };
+
+            // keeping all digits of plain decimal numbers for deep zooms
+            FixedPoint preciseX;
+            FixedPoint preciseY;
+            if (tryParse(*(args - 1), &preciseX) && tryParse(*args, &preciseY))
+            {
+                config.preciseCenter = true;
+                config.preciseCenterX = -preciseX;
+                config.preciseCenterY = -preciseY;
+            }
         }
         // --iterations -i
         else if (arg == "--iterations" || arg == "-i")
@@ -198,7 +208,25 @@ int main(int argc, char** args)
         // --use-double -d
         else if (arg == "--use-double" || arg == "-d")
         {
-            config.useDouble = true;
+            config.precision = Precision::DOUBLE;
+        }
+        // --precision -p
+        else if (arg == "--precision" || arg == "-p")
+        {
+            string val{ *++args };
+            if (val == "float" || val == "f")
+                config.precision = Precision::FLOAT;
+            else if (val == "df64" || val == "df")
+                config.precision = Precision::DF64;
+            else if (val == "double" || val == "d")
+                config.precision = Precision::DOUBLE;
+            else if (val == "auto" || val == "a")
+                config.precision = Precision::AUTO;
+            else
+            {
+                cout << "invalid precision argument '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
         }
         // --bg-color -bg
         else if (arg == "--bg-color" || arg == "-bg")
@@ -274,6 +302,170 @@ int main(int argc, char** args)
             }
             config.fpsLimit = fpsLimit;
         }
+        else if (arg == "--vsync" || arg == "-vs")
+        {
+            config.vsync = true;
+        }
+        else if (arg == "--input-rate" || arg == "-ir")
+        {
+            double inputRate;
+            if (!tryParse(*++args, &inputRate) || inputRate <= 0)
+            {
+                cout << "invalid input rate '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+            config.inputRate = inputRate;
+        }
+        else if (arg == "--iteration-slice" || arg == "-is")
+        {
+            int iterationSlice;
+            if (!tryParse(*++args, &iterationSlice) || iterationSlice < 0)
+            {
+                cout << "invalid iteration slice '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+            config.iterationSlice = iterationSlice;
+        }
+        else if (arg == "--interaction-fps" || arg == "-ifps")
+        {
+            double interactionFps;
+            if (!tryParse(*++args, &interactionFps) || interactionFps < 0)
+            {
+                cout << "invalid interaction fps '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+            config.interactionFps = interactionFps;
+        }
+        else if (arg == "--idle-time" || arg == "-it")
+        {
+            double idleTime;
+            if (!tryParse(*++args, &idleTime) || idleTime < 0)
+            {
+                cout << "invalid idle time '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+            config.idleTime = idleTime;
+        }
+        else if (arg == "--antialiasing" || arg == "-aa")
+        {
+            int antialiasing;
+            if (!tryParse(*++args, &antialiasing) || antialiasing <= 0)
+            {
+                cout << "invalid antialiasing samples '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+            config.antialiasing = antialiasing;
+        }
+        else if (arg == "--cache-gpu" || arg == "-cg")
+        {
+            int cacheGpuMemory;
+            if (!tryParse(*++args, &cacheGpuMemory) || cacheGpuMemory < 0)
+            {
+                cout << "invalid cache gpu memory '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+            config.cacheGpuMemory = cacheGpuMemory;
+        }
+        else if (arg == "--cache-ram" || arg == "-cr")
+        {
+            int cacheHostMemory;
+            if (!tryParse(*++args, &cacheHostMemory) || cacheHostMemory < 0)
+            {
+                cout << "invalid cache ram memory '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+            config.cacheHostMemory = cacheHostMemory;
+        }
+        else if (arg == "--periodicity-tolerance" || arg == "-pt")
+        {
+            double periodicityTolerance;
+            if (!tryParse(*++args, &periodicityTolerance) || periodicityTolerance < 0)
+            {
+                cout << "invalid periodicity tolerance '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+            config.periodicityTolerance = periodicityTolerance;
+        }
+        else if (arg == "--headless" || arg == "-hl")
+        {
+            config.headless = true;
+        }
+        else if (arg == "--output" || arg == "-o")
+        {
+            if (!*++args)
+            {
+                cout << "missing output path" << endl;
+                return EXIT_FAILURE;
+            }
+            config.outputPath = *args;
+            config.headless = true;
+        }
+        else if (arg == "--gpu-times" || arg == "-gt")
+        {
+            if (!*++args)
+            {
+                cout << "missing gpu times path" << endl;
+                return EXIT_FAILURE;
+            }
+            config.gpuTimesPath = *args;
+        }
+        else if (arg == "--trace" || arg == "-tr")
+        {
+            if (!*++args)
+            {
+                cout << "missing trace path" << endl;
+                return EXIT_FAILURE;
+            }
+            config.tracePath = *args;
+        }
+        else if (arg == "--size" || arg == "-sz")
+        {
+            int width;
+            int height;
+            if (!tryParse(*++args, &width) || width <= 0)
+            {
+                cout << "invalid width argument '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+            if (!tryParse(*++args, &height) || height <= 0)
+            {
+                cout << "invalid height argument '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+            config.width = width;
+            config.height = height;
+        }
+        else if (arg == "--backend" || arg == "-b")
+        {
+            string val{ *++args };
+            if (val == "gpu")
+                config.backend = Backend::GPU;
+            else if (val == "cpu")
+                config.backend = Backend::CPU;
+            else
+            {
+                cout << "invalid backend argument '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--threads" || arg == "-t")
+        {
+            int threadCount;
+            if (!tryParse(*++args, &threadCount) || threadCount < 0)
+            {
+                cout << "invalid thread count '" << *args << "'" << endl;
+                return EXIT_FAILURE;
+            }
+            config.threadCount = threadCount;
+        }
+        else if (arg == "--no-subdivision" || arg == "-ns")
+        {
+            config.subdivision = false;
+        }
+        else if (arg == "--no-tiles" || arg == "-nt")
+        {
+            config.tiles = false;
+        }
         else if (arg == "--roots" || arg == "-r")
         {
             for (config.rootCount = 0; *++args && *args != string{"r"}; config.rootCount++)
@@ -308,7 +500,7 @@ int main(int argc, char** args)
         goto exit;
     }
 
-    if ((rm = GLFractal::mainloop()) != GLFResult::OK)
+    if ((rm = config.headless ? GLFractal::renderToFile(config.outputPath) : GLFractal::mainloop()) != GLFResult::OK)
     {
         printMessage(rm);
         goto exit;
@@ -348,6 +540,19 @@ void printMessage(GLFResult rm)
         break;
     case GLFResult::SOME_CHARACTERS_MISSING:
         cout << "Some font characters failed to load" << endl;
+        break;
+    case GLFResult::FRAMEBUFFER_INIT_ERROR:
+        cout << "Failed to create framebuffer" << endl;
+        break;
+    case GLFResult::OUTPUT_WRITE_ERROR:
+        cout << "Failed to write the output image" << endl;
+        break;
+    case GLFResult::TIMES_WRITE_ERROR:
+        cout << "Failed to write the gpu times" << endl;
+        break;
+    case GLFResult::TRACE_WRITE_ERROR:
+        cout << "Failed to write the trace" << endl;
+        break;
     default:
         break;
     }
@@ -370,7 +575,7 @@ void printHelp()
     cout << "    glfractal -s 1.0\n";
     cout << "\n";
     cout << "  --center  -c\n";
-    cout << "    sets position of center of the screen as a complex number\n";
+    cout << "    sets position of center of the screen as a complex number (all digits of decimal numbers are kept for deep zooms)\n";
     cout << "    glfractal -c 0.0 0.0\n";
     cout << "\n";
     cout << "  --iterations  -i\n";
@@ -422,6 +627,15 @@ void printHelp()
     cout << "  --use-double  -d\n";
     cout << "    determines whether double floating point arithmetic should be used on the gpu (significantly decreases performance)\n";
     cout << "\n";
+    cout << "  --precision  -p\n";
+    cout << "    sets the arithmetic of the main view\n";
+    cout << "    Possible values:\n";
+    cout << "      float  | f\n";
+    cout << "      df64   | df  (pair of floats, more precise than float and usually faster than double)\n";
+    cout << "      double | d\n";
+    cout << "      auto   | a   (default, picks the cheapest one that still resolves pixels at the current zoom)\n";
+    cout << "    glfractal -p df64\n";
+    cout << "\n";
     cout << "  --bg-color  -bg\n";
     cout << "    sets the clear background color (in hex)\n";
     cout << "    glfractal -bg 191919\n";
@@ -450,6 +664,76 @@ void printHelp()
     cout << "    sets the fps limit\n";
     cout << "    glfractal -fps 10000.0\n";
     cout << "\n";
+    cout << "  --vsync  -vs\n";
+    cout << "    synchronizes the frames with the refresh rate of the monitor\n";
+    cout << "\n";
+    cout << "  --input-rate  -ir\n";
+    cout << "    sets how many times per second is the input sampled while waiting for the next frame\n";
+    cout << "    glfractal -ir 240.0\n";
+    cout << "\n";
+    cout << "  --iteration-slice  -is\n";
+    cout << "    sets how many iterations are done for each pixel in one frame (0 does all iterations at once)\n";
+    cout << "    glfractal -is 1000\n";
+    cout << "\n";
+    cout << "  --interaction-fps  -ifps\n";
+    cout << "    sets the fps kept while the view is changing by rendering it at lower resolution (0 always renders full resolution)\n";
+    cout << "    glfractal -ifps 60.0\n";
+    cout << "\n";
+    cout << "  --idle-time  -it\n";
+    cout << "    sets the time in seconds without changes after which the view is rendered again in full resolution\n";
+    cout << "    glfractal -it 0.25\n";
+    cout << "\n";
+    cout << "  --antialiasing  -aa\n";
+    cout << "    sets the number of samples of the pixels on edges of the finished view (1 disables antialiasing)\n";
+    cout << "    glfractal -aa 16\n";
+    cout << "\n";
+    cout << "  --cache-gpu  -cg\n";
+    cout << "    sets the megabytes of gpu memory for finished images that are reused when the view is visited again (0 disables it)\n";
+    cout << "    glfractal -cg 128\n";
+    cout << "\n";
+    cout << "  --cache-ram  -cr\n";
+    cout << "    sets the megabytes of ram for finished images that don't fit into the gpu memory of the cache (0 disables it)\n";
+    cout << "    glfractal -cr 512\n";
+    cout << "\n";
+    cout << "  --periodicity-tolerance  -pt\n";
+    cout << "    sets how close z has to come to its earlier value to be taken as a cycle, relative to the distance between pixels (0 disables it)\n";
+    cout << "    glfractal -pt 0.001\n";
+    cout << "\n";
+    cout << "  --headless  -hl\n";
+    cout << "    renders only the main view into image without showing the window\n";
+    cout << "\n";
+    cout << "  --output  -o\n";
+    cout << "    sets the path of the image rendered in headless mode (binary ppm), implies --headless\n";
+    cout << "    glfractal -o fractal.ppm\n";
+    cout << "\n";
+    cout << "  --gpu-times  -gt\n";
+    cout << "    writes the min, average and 99th percentile gpu time of each render pass into csv file when the program ends\n";
+    cout << "    glfractal -gt times.csv\n";
+    cout << "\n";
+    cout << "  --trace  -tr\n";
+    cout << "    records the cpu and gpu timeline of the frames and writes it into json file (chrome trace, opens in perfetto) when the program ends\n";
+    cout << "    glfractal -tr trace.json\n";
+    cout << "\n";
+    cout << "  --size  -sz\n";
+    cout << "    sets the width and height of the image rendered in headless mode\n";
+    cout << "    glfractal -sz 1000 1000\n";
+    cout << "\n";
+    cout << "  --backend  -b\n";
+    cout << "    sets where the main view is iterated\n";
+    cout << "      gpu\n";
+    cout << "      cpu (SIMD on multiple threads)\n";
+    cout << "    glfractal -b cpu\n";
+    cout << "\n";
+    cout << "  --threads  -t\n";
+    cout << "    sets the number of threads used by the cpu backend (0 uses all cores)\n";
+    cout << "    glfractal -t 0\n";
+    cout << "\n";
+    cout << "  --no-subdivision  -ns\n";
+    cout << "    iterates every pixel on the cpu instead of filling mandelbrot and julia rectangles whose border has one color\n";
+    cout << "\n";
+    cout << "  --no-tiles  -nt\n";
+    cout << "    iterates the main view with the fragment shaders instead of dispatching the unfinished tiles to the compute shaders\n";
+    cout << "\n";
     cout << "  --roots  -r\n";
     cout << "    sets the roots of polynomial (1 root has real and complex component), there must be 'r' after the last root\n";
     cout << "    glfractal 1.0 0.0 -0.5 -0.86603 -0.5 0.86603 r\n";
@@ -508,7 +792,7 @@ void printHelp()
     cout << "    2048 : Alt + O\n";
     cout << "\n";
     cout << "  Render:\n";
-    cout << "    toggle double : Tab\n";
+    cout << "    cycle precision : Tab\n";
     cout << "\n";
     cout << "  Reset (hold space to use it for selector):\n";
     cout << "    zoom and center  : R\n";
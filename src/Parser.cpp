@@ -45,6 +45,32 @@ namespace Parser
         return false;
     }
 
+    bool tryParse(char* str, FixedPoint* num)
+    {
+        // only plain decimal numbers, all of the digits are kept
+        string s{ str };
+        bool negative = !s.empty() && s[0] == '-';
+        size_t start = negative ? 1 : 0;
+        size_t point = s.find('.', start);
+
+        string whole = s.substr(start, point == string::npos ? string::npos : point - start);
+        string frac = point == string::npos ? "" : s.substr(point + 1);
+        if ((whole.empty() && frac.empty()) || whole.size() > 9)
+            return false;
+        if (whole.find_first_not_of("0123456789") != string::npos || frac.find_first_not_of("0123456789") != string::npos)
+            return false;
+
+        // decimal digit has less than 4 bits
+        FixedPoint res(0.0, FixedPoint::limbsForBits((int)frac.size() * 4 + 64));
+        for (auto digit = frac.rbegin(); digit != frac.rend(); digit++)
+            res = (res + FixedPoint((double)(*digit - '0'))).divide(10);
+        if (!whole.empty())
+            res = res + FixedPoint(std::stod(whole));
+
+        *num = negative ? -res : res;
+        return true;
+    }
+
     bool tryParseHex(char* str, unsigned int* num)
     {
         try
@@ -57,9 +83,14 @@ namespace Parser
     }
 
     string toString(double d)
+    {
+        return toString(d, 12);
+    }
+
+    string toString(double d, int precision)
     {
         ostringstream ss;
-        ss.precision(12);
+        ss.precision(precision);
         ss << d;
         return ss.str();
     }
@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include "FixedPoint.hpp"
+
 using std::string;
 
 namespace Parser
@@ -9,8 +11,10 @@ namespace Parser
     bool tryParse(char* str, double* num);
     bool tryParse(char* str, int* num);
     bool tryParse(char* str, float* num);
+    bool tryParse(char* str, FixedPoint* num);
 
     bool tryParseHex(char* str, unsigned int* num);
 
     string toString(double d);
+    string toString(double d, int precision);
 }
@@ -4,17 +4,21 @@
 #include <fstream>
 #include <memory>
 #include <iostream>
+#include <cstring>
 
 #include "Shader.hpp"
 #include "Vectors.hpp"
+#include "Tracer.hpp"
 
-using std::cout, std::endl, std::istreambuf_iterator, std::unique_ptr;
+using std::cout, std::endl, std::istreambuf_iterator, std::unique_ptr, std::memcmp, std::memcpy;
 
 bool _createShader(const char* source, GLuint* shader, GLenum type);
 bool _createShaderFromFile(const char* path, GLuint* shader, GLenum type);
 bool _createShaderProgram(const GLuint vertex, const GLuint fragment, GLuint* program);
 bool _createShaderProgram(const char* vertexSource, const char* fragmentSource, GLuint* program);
 bool _createShaderProgramFromFile(const char* vertexPath, const char* fragmentPath, GLuint* program);
+bool _createComputeProgramFromFiles(const char* computePath, const char* kernelPath, GLuint* program);
+bool _readFile(const char* path, string& str);
 
 Shader::Shader() : _id(0), _isCreated(false) {}
 
@@ -26,6 +30,7 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) : updateFun([](
 		return;
 	}
 	_isCreated = true;
+	_loadUniforms();
 }
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath, function<void(Shader& shader)> update) : updateFun(update)
@@ -36,6 +41,18 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath, function<void(S
 		return;
 	}
 	_isCreated = true;
+	_loadUniforms();
+}
+
+Shader Shader::compute(const char* computePath, const char* kernelPath, function<void(Shader& shader)> update)
+{
+	Shader shader;
+	shader.updateFun = update;
+	if (!_createComputeProgramFromFiles(computePath, kernelPath, &shader._id))
+		return shader;
+	shader._isCreated = true;
+	shader._loadUniforms();
+	return shader;
 }
 
 GLuint Shader::getId()
@@ -55,6 +72,7 @@ void Shader::use()
 
 void Shader::update()
 {
+	Tracer::Scope trace("Shader::update", _id);
 	updateFun(*this);
 }
 
@@ -63,83 +81,267 @@ void Shader::free()
 	glDeleteProgram(_id);
 }
 
+Shader::Uniform Shader::getUniform(const char* name)
+{
+	unordered_map<string, int>& ids = _uniformIds();
+	auto it = ids.find(name);
+	if (it == ids.end())
+		it = ids.emplace(name, (int)ids.size()).first;
+	return Uniform{ it->second };
+}
+
 void Shader::setInt(const char* name, GLint x)
 {
-	glUniform1i(glGetUniformLocation(_id, name), x);
+	setInt(getUniform(name), x);
+}
+
+void Shader::setInt(Uniform uniform, GLint x)
+{
+	if (_changed(uniform, &x, sizeof(x)))
+		glUniform1i(_uniforms[uniform.index].location, x);
+}
+
+void Shader::setInt2(const char* name, GLint x, GLint y)
+{
+	setInt2(getUniform(name), x, y);
+}
+
+void Shader::setInt2(Uniform uniform, GLint x, GLint y)
+{
+	GLint value[] = { x, y };
+	if (_changed(uniform, value, sizeof(value)))
+		glUniform2i(_uniforms[uniform.index].location, x, y);
 }
 
 void Shader::setFloat(const char* name, GLfloat x)
 {
-	glUniform1f(glGetUniformLocation(_id, name), x);
+	setFloat(getUniform(name), x);
+}
+
+void Shader::setFloat(Uniform uniform, GLfloat x)
+{
+	if (_changed(uniform, &x, sizeof(x)))
+		glUniform1f(_uniforms[uniform.index].location, x);
 }
 
 void Shader::setDouble(const char* name, GLdouble x)
 {
-	glUniform1d(glGetUniformLocation(_id, name), x);
+	setDouble(getUniform(name), x);
+}
+
+void Shader::setDouble(Uniform uniform, GLdouble x)
+{
+	if (_changed(uniform, &x, sizeof(x)))
+		glUniform1d(_uniforms[uniform.index].location, x);
 }
 
 void Shader::setFloat2(const char* name, GLfloat x, GLfloat y)
 {
-	glUniform2f(glGetUniformLocation(_id, name), x, y);
+	setFloat2(getUniform(name), x, y);
+}
+
+void Shader::setFloat2(Uniform uniform, GLfloat x, GLfloat y)
+{
+	GLfloat value[] = { x, y };
+	if (_changed(uniform, value, sizeof(value)))
+		glUniform2f(_uniforms[uniform.index].location, x, y);
 }
 
 void Shader::setFloat2(const char* name, Vec2 xy)
 {
-	glUniform2f(glGetUniformLocation(_id, name), xy.x, xy.y);
+	setFloat2(getUniform(name), xy.x, xy.y);
+}
+
+void Shader::setFloat2(Uniform uniform, Vec2 xy)
+{
+	setFloat2(uniform, xy.x, xy.y);
 }
 
 void Shader::setDouble2(const char* name, GLdouble x, GLdouble y)
 {
-	glUniform2d(glGetUniformLocation(_id, name), x, y);
+	setDouble2(getUniform(name), x, y);
+}
+
+void Shader::setDouble2(Uniform uniform, GLdouble x, GLdouble y)
+{
+	GLdouble value[] = { x, y };
+	if (_changed(uniform, value, sizeof(value)))
+		glUniform2d(_uniforms[uniform.index].location, x, y);
 }
 
 void Shader::setDouble2(const char* name, DVec2 xy)
 {
-	glUniform2d(glGetUniformLocation(_id, name), xy.x, xy.y);
+	setDouble2(getUniform(name), xy.x, xy.y);
+}
+
+void Shader::setDouble2(Uniform uniform, DVec2 xy)
+{
+	setDouble2(uniform, xy.x, xy.y);
 }
 
 void Shader::setFloat3(const char* name, GLfloat x, GLfloat y, GLfloat z)
 {
-	glUniform3f(glGetUniformLocation(_id, name), x, y, z);
+	setFloat3(getUniform(name), x, y, z);
+}
+
+void Shader::setFloat3(Uniform uniform, GLfloat x, GLfloat y, GLfloat z)
+{
+	GLfloat value[] = { x, y, z };
+	if (_changed(uniform, value, sizeof(value)))
+		glUniform3f(_uniforms[uniform.index].location, x, y, z);
 }
 
 void Shader::setFloat3(const char* name, Vec3 xyz)
 {
-	glUniform3f(glGetUniformLocation(_id, name), xyz.x, xyz.y, xyz.z);
+	setFloat3(getUniform(name), xyz.x, xyz.y, xyz.z);
+}
+
+void Shader::setFloat3(Uniform uniform, Vec3 xyz)
+{
+	setFloat3(uniform, xyz.x, xyz.y, xyz.z);
+}
+
+void Shader::setDoubleFloat(const char* name, GLdouble x)
+{
+	setDoubleFloat(getUniform(name), x);
+}
+
+void Shader::setDoubleFloat(Uniform uniform, GLdouble x)
+{
+	GLfloat hi = (GLfloat)x;
+	GLfloat value[] = { hi, (GLfloat)(x - hi) };
+	if (_changed(uniform, value, sizeof(value)))
+		glUniform2fv(_uniforms[uniform.index].location, 1, value);
+}
+
+void Shader::setDoubleFloat2(const char* name, DVec2 xy)
+{
+	setDoubleFloat2(getUniform(name), xy);
+}
+
+void Shader::setDoubleFloat2(Uniform uniform, DVec2 xy)
+{
+	GLfloat hiX = (GLfloat)xy.x;
+	GLfloat hiY = (GLfloat)xy.y;
+	GLfloat value[] = { hiX, (GLfloat)(xy.x - hiX), hiY, (GLfloat)(xy.y - hiY) };
+	if (_changed(uniform, value, sizeof(value)))
+		glUniform4fv(_uniforms[uniform.index].location, 1, value);
 }
 
 void Shader::setMatrix4(const char* name, Mat4 matrix)
 {
-	glUniformMatrix4fv(glGetUniformLocation(_id, name), 1, GL_TRUE, matrix.data());
+	setMatrix4(getUniform(name), matrix.data());
+}
+
+void Shader::setMatrix4(Uniform uniform, Mat4 matrix)
+{
+	setMatrix4(uniform, matrix.data());
 }
 
 void Shader::setMatrix4(const char* name, const float* data)
 {
-	glUniformMatrix4fv(glGetUniformLocation(_id, name), 1, GL_TRUE, data);
+	setMatrix4(getUniform(name), data);
+}
+
+void Shader::setMatrix4(Uniform uniform, const float* data)
+{
+	if (_changed(uniform, data, sizeof(float) * 16))
+		glUniformMatrix4fv(_uniforms[uniform.index].location, 1, GL_TRUE, data);
 }
 
 void Shader::setFloat2Array(const char* name, const int length, const Vec2* arr)
 {
-	glUniform2fv(glGetUniformLocation(_id, name), length, (GLfloat*)arr);
+	setFloat2Array(getUniform(name), length, arr);
+}
+
+void Shader::setFloat2Array(Uniform uniform, const int length, const Vec2* arr)
+{
+	if (_changed(uniform, arr, sizeof(GLfloat) * 2 * length))
+		glUniform2fv(_uniforms[uniform.index].location, length, (GLfloat*)arr);
 }
 
 void Shader::setFloat2Array(const char* name, const int length, const DVec2* arr)
 {
-	unique_ptr<float> converted{new float[length * 2]};
+	setFloat2Array(getUniform(name), length, arr);
+}
+
+void Shader::setFloat2Array(Uniform uniform, const int length, const DVec2* arr)
+{
+	unique_ptr<float[]> converted{new float[length * 2]};
 	for (int i = 0; i < length; i++)
 	{
 		converted.get()[i * 2] = (float)arr[i].x;
 		converted.get()[i * 2 + 1] = (float)arr[i].y;
 	}
-	glUniform2fv(glGetUniformLocation(_id, name), length, converted.get());
+	if (_changed(uniform, converted.get(), sizeof(GLfloat) * 2 * length))
+		glUniform2fv(_uniforms[uniform.index].location, length, converted.get());
 }
 
 void Shader::setDouble2Array(const char* name, const int length, const DVec2* arr)
 {
-	glUniform2dv(glGetUniformLocation(_id, name), length, (GLdouble*)arr);
+	setDouble2Array(getUniform(name), length, arr);
 }
 
-bool _createShaderFromFile(const char* path, GLuint* shader, GLenum type)
+void Shader::setDouble2Array(Uniform uniform, const int length, const DVec2* arr)
+{
+	if (_changed(uniform, arr, sizeof(GLdouble) * 2 * length))
+		glUniform2dv(_uniforms[uniform.index].location, length, (GLdouble*)arr);
+}
+
+void Shader::_loadUniforms()
+{
+	GLint count;
+	glGetProgramiv(_id, GL_ACTIVE_UNIFORMS, &count);
+
+	GLint maxLength;
+	glGetProgramiv(_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+	unique_ptr<char[]> name{ new char[maxLength] };
+
+	for (GLint i = 0; i < count; i++)
+	{
+		GLint size;
+		GLenum type;
+		glGetActiveUniform(_id, i, maxLength, NULL, &size, &type, name.get());
+
+		// variables in uniform blocks have no location
+		GLint location = glGetUniformLocation(_id, name.get());
+		if (location < 0)
+			continue;
+
+		// arrays are reported as 'name[0]'
+		string key{ name.get() };
+		if (key.ends_with("[0]"))
+			key.resize(key.length() - 3);
+
+		Uniform uniform = getUniform(key.c_str());
+		if (uniform.index >= (int)_uniforms.size())
+			_uniforms.resize(uniform.index + 1, _UniformSlot{ -1, {} });
+		_uniforms[uniform.index].location = location;
+	}
+}
+
+bool Shader::_changed(Uniform uniform, const void* value, size_t size)
+{
+	if (uniform.index < 0 || uniform.index >= (int)_uniforms.size() || _uniforms[uniform.index].location < 0)
+		return false;
+
+	vector<unsigned char>& last = _uniforms[uniform.index].value;
+	if (last.size() == size && memcmp(last.data(), value, size) == 0)
+		return false;
+
+	last.resize(size);
+	memcpy(last.data(), value, size);
+	return true;
+}
+
+unordered_map<string, int>& Shader::_uniformIds()
+{
+	// created on first use, the handles can be resolved during static initialization
+	static unordered_map<string, int> ids;
+	return ids;
+}
+
+bool _readFile(const char* path, string& str)
 {
 	ifstream file(path);
 
@@ -149,7 +351,15 @@ bool _createShaderFromFile(const char* path, GLuint* shader, GLenum type)
 		return false;
 	}
 
-	string str(istreambuf_iterator<char>{file}, {});
+	str.assign(istreambuf_iterator<char>{file}, {});
+	return true;
+}
+
+bool _createShaderFromFile(const char* path, GLuint* shader, GLenum type)
+{
+	string str;
+	if (!_readFile(path, str))
+		return false;
 	return _createShader(str.c_str(), shader, type);
 }
 
@@ -239,4 +449,37 @@ bool _createShaderProgramFromFile(const char* vertexPath, const char* fragmentPa
 	glDeleteShader(fragment);
 
 	return res;
+}
+
+bool _createComputeProgramFromFiles(const char* computePath, const char* kernelPath, GLuint* program)
+{
+	string compute, kernel;
+	if (!_readFile(computePath, compute) || !_readFile(kernelPath, kernel))
+		return false;
+
+	// only the compute source has the version line, the line break is kept so that the lines are numbered the same
+	if (kernel.rfind("#version", 0) == 0)
+		kernel.erase(0, kernel.find('\n'));
+
+	GLuint shader;
+	if (!_createShader((compute + kernel).c_str(), &shader, GL_COMPUTE_SHADER))
+		return false;
+
+	*program = glCreateProgram();
+	glAttachShader(*program, shader);
+	glLinkProgram(*program);
+	glDeleteShader(shader);
+
+	int success;
+	char infoLog[512];
+	glGetProgramiv(*program, GL_LINK_STATUS, &success);
+
+	if (!success)
+	{
+		glGetProgramInfoLog(*program, 512, NULL, infoLog);
+		cout << "Couldn't link shaders" << endl << infoLog << endl;
+		return false;
+	}
+
+	return true;
 }
\ No newline at end of file
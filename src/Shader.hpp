@@ -3,14 +3,24 @@
 #include <GLFW/glfw3.h>
 
 #include <functional>
+#include <vector>
+#include <unordered_map>
 
 #include "Vectors.hpp"
 
-using std::ifstream, std::function;
+using std::ifstream, std::function, std::vector, std::unordered_map;
 
 class Shader
 {
 public:
+	/// <summary>
+	/// Handle to uniform variable, the same handle is used for the variable of that name in all shaders
+	/// (setting uniform by handle skips the name lookup)
+	/// </summary>
+	struct Uniform
+	{
+		int index = -1;
+	};
 	/// <summary>
 	/// Creates new shader from given files (check 'isCreated()' to ensure that shader was properly created)
 	/// </summary>
@@ -29,6 +39,15 @@ public:
 	/// <param name="update">Function that will update data in shader</param>
 	Shader(const char* vertexPath, const char* fragmentPath, function<void(Shader& shader)> update);
 	/// <summary>
+	/// Creates new compute shader from the compute source followed by the source of another shader without
+	/// its version line (check 'isCreated()' to ensure that shader was properly created)
+	/// </summary>
+	/// <param name="computePath">Path to compute shader</param>
+	/// <param name="kernelPath">Path to shader appended to the compute shader</param>
+	/// <param name="update">Function that will update data in shader</param>
+	/// <returns>The compute shader</returns>
+	static Shader compute(const char* computePath, const char* kernelPath, function<void(Shader& shader)> update);
+	/// <summary>
 	/// Gets the shaders id
 	/// </summary>
 	/// <returns>This shaders ID</returns>
@@ -51,24 +70,63 @@ public:
 	/// </summary>
 	void free();
 	/// <summary>
+	/// Gets handle to uniform variable, can be resolved once before the shaders are created
+	/// (shaders without active variable of that name ignore the handle in the setters)
+	/// </summary>
+	/// <param name="name">name of variable</param>
+	/// <returns>Handle to the variable</returns>
+	static Uniform getUniform(const char* name);
+	/// <summary>
 	/// Sets uniform int
 	/// </summary>
 	/// <param name="name">name of variable</param>
 	/// <param name="x">value of variable</param>
 	void setInt(const char* name, GLint x);
 	/// <summary>
+	/// Sets uniform int
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="x">value of variable</param>
+	void setInt(Uniform uniform, GLint x);
+	/// <summary>
+	/// Sets uniform ivec2
+	/// </summary>
+	/// <param name="name">name of variable</param>
+	/// <param name="x">x value of variable</param>
+	/// <param name="y">y value of variable</param>
+	void setInt2(const char* name, GLint x, GLint y);
+	/// <summary>
+	/// Sets uniform ivec2
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="x">x value of variable</param>
+	/// <param name="y">y value of variable</param>
+	void setInt2(Uniform uniform, GLint x, GLint y);
+	/// <summary>
 	/// Sets uniform float
 	/// </summary>
 	/// <param name="name">name of variable</param>
 	/// <param name="x">value of variable</param>
 	void setFloat(const char* name, GLfloat x);
 	/// <summary>
+	/// Sets uniform float
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="x">value of variable</param>
+	void setFloat(Uniform uniform, GLfloat x);
+	/// <summary>
 	/// Sets uniform double
 	/// </summary>
 	/// <param name="name">name of variable</param>
 	/// <param name="x">value of variable</param>
 	void setDouble(const char* name, GLdouble x);
 	/// <summary>
+	/// Sets uniform double
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="x">value of variable</param>
+	void setDouble(Uniform uniform, GLdouble x);
+	/// <summary>
 	/// Sets uniform vec2
 	/// </summary>
 	/// <param name="name">name of variable</param>
@@ -78,10 +136,23 @@ public:
 	/// <summary>
 	/// Sets uniform vec2
 	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="x">component x</param>
+	/// <param name="y">component y</param>
+	void setFloat2(Uniform uniform, GLfloat x, GLfloat y);
+	/// <summary>
+	/// Sets uniform vec2
+	/// </summary>
 	/// <param name="name">name of variable</param>
 	/// <param name="xy">value of variable</param>
 	void setFloat2(const char* name, Vec2 xy);
 	/// <summary>
+	/// Sets uniform vec2
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="xy">value of variable</param>
+	void setFloat2(Uniform uniform, Vec2 xy);
+	/// <summary>
 	/// Sets univorm dvec2
 	/// </summary>
 	/// <param name="name">name of variable</param>
@@ -89,12 +160,25 @@ public:
 	/// <param name="y">component y</param>
 	void setDouble2(const char* name, GLdouble x, GLdouble y);
 	/// <summary>
+	/// Sets univorm dvec2
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="x">component x</param>
+	/// <param name="y">component y</param>
+	void setDouble2(Uniform uniform, GLdouble x, GLdouble y);
+	/// <summary>
 	/// Sets uniform dvec2
 	/// </summary>
 	/// <param name="name">name of variable</param>
 	/// <param name="xy">value of variable</param>
 	void setDouble2(const char* name, DVec2 xy);
 	/// <summary>
+	/// Sets uniform dvec2
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="xy">value of variable</param>
+	void setDouble2(Uniform uniform, DVec2 xy);
+	/// <summary>
 	/// Sets uniform vec3
 	/// </summary>
 	/// <param name="name">name of variable</param>
@@ -105,22 +189,72 @@ public:
 	/// <summary>
 	/// Sets uniform vec3
 	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="x">component x</param>
+	/// <param name="y">component y</param>
+	/// <param name="z">component z</param>
+	void setFloat3(Uniform uniform, GLfloat x, GLfloat y, GLfloat z);
+	/// <summary>
+	/// Sets uniform vec3
+	/// </summary>
 	/// <param name="name">name of variable</param>
 	/// <param name="xyz">value of variable</param>
 	void setFloat3(const char* name, Vec3 xyz);
 	/// <summary>
+	/// Sets uniform vec3
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="xyz">value of variable</param>
+	void setFloat3(Uniform uniform, Vec3 xyz);
+	/// <summary>
+	/// Sets uniform vec2 to double split into double-float (high and low part)
+	/// </summary>
+	/// <param name="name">name of variable</param>
+	/// <param name="x">value of variable</param>
+	void setDoubleFloat(const char* name, GLdouble x);
+	/// <summary>
+	/// Sets uniform vec2 to double split into double-float (high and low part)
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="x">value of variable</param>
+	void setDoubleFloat(Uniform uniform, GLdouble x);
+	/// <summary>
+	/// Sets uniform vec4 to dvec2 split into double-floats (x high, x low, y high, y low)
+	/// </summary>
+	/// <param name="name">name of variable</param>
+	/// <param name="xy">value of variable</param>
+	void setDoubleFloat2(const char* name, DVec2 xy);
+	/// <summary>
+	/// Sets uniform vec4 to dvec2 split into double-floats (x high, x low, y high, y low)
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="xy">value of variable</param>
+	void setDoubleFloat2(Uniform uniform, DVec2 xy);
+	/// <summary>
 	/// Sets uniform mat4
 	/// </summary>
 	/// <param name="name">name of variable</param>
 	/// <param name="matrix">value of variable</param>
 	void setMatrix4(const char* name, Mat4 matrix);
 	/// <summary>
+	/// Sets uniform mat4
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="matrix">value of variable</param>
+	void setMatrix4(Uniform uniform, Mat4 matrix);
+	/// <summary>
 	/// Sets uniform mat43
 	/// </summary>
 	/// <param name="name">name of variable</param>
 	/// <param name="data">value of variable</param>
 	void setMatrix4(const char* name, const float* data);
 	/// <summary>
+	/// Sets uniform mat43
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="data">value of variable</param>
+	void setMatrix4(Uniform uniform, const float* data);
+	/// <summary>
 	/// Sets uniform vec2 array
 	/// </summary>
 	/// <param name="name">name of variable</param>
@@ -128,6 +262,13 @@ public:
 	/// <param name="arr">array</param>
 	void setFloat2Array(const char* name, const int length, const Vec2* arr);
 	/// <summary>
+	/// Sets uniform vec2 array
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="length"length of the array></param>
+	/// <param name="arr">array</param>
+	void setFloat2Array(Uniform uniform, const int length, const Vec2* arr);
+	/// <summary>
 	/// Sets uniform vec2 array from DVec2 array
 	/// </summary>
 	/// <param name="name">name of variable</param>
@@ -135,6 +276,13 @@ public:
 	/// <param name="arr">array</param>
 	void setFloat2Array(const char* name, const int length, const DVec2* arr);
 	/// <summary>
+	/// Sets uniform vec2 array from DVec2 array
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="length"length of the array></param>
+	/// <param name="arr">array</param>
+	void setFloat2Array(Uniform uniform, const int length, const DVec2* arr);
+	/// <summary>
 	/// Sets uniform dvec2 array
 	/// </summary>
 	/// <param name="name">name of variable</param>
@@ -142,11 +290,32 @@ public:
 	/// <param name="arr">array</param>
 	void setDouble2Array(const char* name, const int length, const DVec2* arr);
 	/// <summary>
+	/// Sets uniform dvec2 array
+	/// </summary>
+	/// <param name="uniform">handle of variable</param>
+	/// <param name="length"length of the array></param>
+	/// <param name="arr">array</param>
+	void setDouble2Array(Uniform uniform, const int length, const DVec2* arr);
+	/// <summary>
 	/// Function that updates the value of shader
 	/// </summary>
 	function<void(Shader &shader)> updateFun;
 private:
+	struct _UniformSlot
+	{
+		GLint location;
+		// last value set to the uniform, same values are not sent again
+		vector<unsigned char> value;
+	};
+
 	GLuint _id;
 	bool _isCreated;
+	// indexed by the handles, variables missing in this shader have location -1
+	vector<_UniformSlot> _uniforms;
+
+	static unordered_map<string, int>& _uniformIds();
+
+	void _loadUniforms();
+	bool _changed(Uniform uniform, const void* value, size_t size);
 };
 
@@ -0,0 +1,313 @@
+#pragma once
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/// <summary>
+/// Packs of numbers that are processed together with SIMD instructions (the widest instruction set enabled when compiling
+/// the file is used). Files compiled for different instruction sets get their own packs in a namespace named after the set
+/// </summary>
+namespace Simd
+{
+#if defined(__AVX512F__)
+inline namespace Avx512
+{
+#elif defined(__AVX2__)
+inline namespace Avx2
+{
+#else
+inline namespace Scalar
+{
+#endif
+
+    /// <summary>
+    /// Generic pack, the operations are done lane by lane and the compiler may vectorize them
+    /// </summary>
+    /// <typeparam name="T">Type of the numbers</typeparam>
+    /// <typeparam name="N">Number of lanes</typeparam>
+    template<typename T, int N>
+    struct Pack
+    {
+        using Scalar = T;
+        static constexpr int lanes = N;
+
+        struct Mask
+        {
+            bool v[N];
+
+            friend Mask operator&(Mask a, Mask b)
+            {
+                Mask r;
+                for (int i = 0; i < N; i++)
+                    r.v[i] = a.v[i] && b.v[i];
+                return r;
+            }
+
+            friend Mask operator|(Mask a, Mask b)
+            {
+                Mask r;
+                for (int i = 0; i < N; i++)
+                    r.v[i] = a.v[i] || b.v[i];
+                return r;
+            }
+
+            friend Mask operator!(Mask a)
+            {
+                Mask r;
+                for (int i = 0; i < N; i++)
+                    r.v[i] = !a.v[i];
+                return r;
+            }
+
+            friend bool any(Mask a)
+            {
+                for (int i = 0; i < N; i++)
+                {
+                    if (a.v[i])
+                        return true;
+                }
+                return false;
+            }
+        };
+
+        T v[N];
+
+        static Pack broadcast(T x)
+        {
+            Pack r;
+            for (int i = 0; i < N; i++)
+                r.v[i] = x;
+            return r;
+        }
+
+        static Pack load(const T* p)
+        {
+            Pack r;
+            for (int i = 0; i < N; i++)
+                r.v[i] = p[i];
+            return r;
+        }
+
+        void store(T* p) const
+        {
+            for (int i = 0; i < N; i++)
+                p[i] = v[i];
+        }
+
+        friend Pack operator+(Pack a, Pack b)
+        {
+            for (int i = 0; i < N; i++)
+                a.v[i] += b.v[i];
+            return a;
+        }
+
+        friend Pack operator-(Pack a, Pack b)
+        {
+            for (int i = 0; i < N; i++)
+                a.v[i] -= b.v[i];
+            return a;
+        }
+
+        friend Pack operator*(Pack a, Pack b)
+        {
+            for (int i = 0; i < N; i++)
+                a.v[i] *= b.v[i];
+            return a;
+        }
+
+        friend Pack operator/(Pack a, Pack b)
+        {
+            for (int i = 0; i < N; i++)
+                a.v[i] /= b.v[i];
+            return a;
+        }
+
+        friend Mask greater(Pack a, Pack b)
+        {
+            Mask r;
+            for (int i = 0; i < N; i++)
+                r.v[i] = a.v[i] > b.v[i];
+            return r;
+        }
+
+        friend Mask less(Pack a, Pack b)
+        {
+            Mask r;
+            for (int i = 0; i < N; i++)
+                r.v[i] = a.v[i] < b.v[i];
+            return r;
+        }
+
+        /// <summary>
+        /// Chooses lanes from 'a' where the mask is set and from 'b' where it is not
+        /// </summary>
+        friend Pack select(Mask m, Pack a, Pack b)
+        {
+            for (int i = 0; i < N; i++)
+                b.v[i] = m.v[i] ? a.v[i] : b.v[i];
+            return b;
+        }
+    };
+
+#if defined(__AVX512F__)
+
+    template<>
+    struct Pack<float, 16>
+    {
+        using Scalar = float;
+        static constexpr int lanes = 16;
+
+        struct Mask
+        {
+            __mmask16 m;
+
+            friend Mask operator&(Mask a, Mask b) { return Mask{ (__mmask16)(a.m & b.m) }; }
+            friend Mask operator|(Mask a, Mask b) { return Mask{ (__mmask16)(a.m | b.m) }; }
+            friend Mask operator!(Mask a) { return Mask{ (__mmask16)~a.m }; }
+            friend bool any(Mask a) { return a.m != 0; }
+        };
+
+        __m512 v;
+
+        static Pack broadcast(float x) { return Pack{ _mm512_set1_ps(x) }; }
+        static Pack load(const float* p) { return Pack{ _mm512_loadu_ps(p) }; }
+        void store(float* p) const { _mm512_storeu_ps(p, v); }
+
+        friend Pack operator+(Pack a, Pack b) { return Pack{ _mm512_add_ps(a.v, b.v) }; }
+        friend Pack operator-(Pack a, Pack b) { return Pack{ _mm512_sub_ps(a.v, b.v) }; }
+        friend Pack operator*(Pack a, Pack b) { return Pack{ _mm512_mul_ps(a.v, b.v) }; }
+        friend Pack operator/(Pack a, Pack b) { return Pack{ _mm512_div_ps(a.v, b.v) }; }
+
+        friend Mask greater(Pack a, Pack b) { return Mask{ _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ) }; }
+        friend Mask less(Pack a, Pack b) { return Mask{ _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ) }; }
+        friend Pack select(Mask m, Pack a, Pack b) { return Pack{ _mm512_mask_blend_ps(m.m, b.v, a.v) }; }
+    };
+
+    template<>
+    struct Pack<double, 8>
+    {
+        using Scalar = double;
+        static constexpr int lanes = 8;
+
+        struct Mask
+        {
+            __mmask8 m;
+
+            friend Mask operator&(Mask a, Mask b) { return Mask{ (__mmask8)(a.m & b.m) }; }
+            friend Mask operator|(Mask a, Mask b) { return Mask{ (__mmask8)(a.m | b.m) }; }
+            friend Mask operator!(Mask a) { return Mask{ (__mmask8)~a.m }; }
+            friend bool any(Mask a) { return a.m != 0; }
+        };
+
+        __m512d v;
+
+        static Pack broadcast(double x) { return Pack{ _mm512_set1_pd(x) }; }
+        static Pack load(const double* p) { return Pack{ _mm512_loadu_pd(p) }; }
+        void store(double* p) const { _mm512_storeu_pd(p, v); }
+
+        friend Pack operator+(Pack a, Pack b) { return Pack{ _mm512_add_pd(a.v, b.v) }; }
+        friend Pack operator-(Pack a, Pack b) { return Pack{ _mm512_sub_pd(a.v, b.v) }; }
+        friend Pack operator*(Pack a, Pack b) { return Pack{ _mm512_mul_pd(a.v, b.v) }; }
+        friend Pack operator/(Pack a, Pack b) { return Pack{ _mm512_div_pd(a.v, b.v) }; }
+
+        friend Mask greater(Pack a, Pack b) { return Mask{ _mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ) }; }
+        friend Mask less(Pack a, Pack b) { return Mask{ _mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ) }; }
+        friend Pack select(Mask m, Pack a, Pack b) { return Pack{ _mm512_mask_blend_pd(m.m, b.v, a.v) }; }
+    };
+
+    using Float = Pack<float, 16>;
+    using Double = Pack<double, 8>;
+
+    /// <summary>
+    /// Name of the instruction set used by the packs
+    /// </summary>
+    inline constexpr const char* instructionSet = "AVX-512";
+
+#elif defined(__AVX2__)
+
+    template<>
+    struct Pack<float, 8>
+    {
+        using Scalar = float;
+        static constexpr int lanes = 8;
+
+        struct Mask
+        {
+            __m256 m;
+
+            friend Mask operator&(Mask a, Mask b) { return Mask{ _mm256_and_ps(a.m, b.m) }; }
+            friend Mask operator|(Mask a, Mask b) { return Mask{ _mm256_or_ps(a.m, b.m) }; }
+            friend Mask operator!(Mask a) { return Mask{ _mm256_xor_ps(a.m, _mm256_castsi256_ps(_mm256_set1_epi32(-1))) }; }
+            friend bool any(Mask a) { return _mm256_movemask_ps(a.m) != 0; }
+        };
+
+        __m256 v;
+
+        static Pack broadcast(float x) { return Pack{ _mm256_set1_ps(x) }; }
+        static Pack load(const float* p) { return Pack{ _mm256_loadu_ps(p) }; }
+        void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+        friend Pack operator+(Pack a, Pack b) { return Pack{ _mm256_add_ps(a.v, b.v) }; }
+        friend Pack operator-(Pack a, Pack b) { return Pack{ _mm256_sub_ps(a.v, b.v) }; }
+        friend Pack operator*(Pack a, Pack b) { return Pack{ _mm256_mul_ps(a.v, b.v) }; }
+        friend Pack operator/(Pack a, Pack b) { return Pack{ _mm256_div_ps(a.v, b.v) }; }
+
+        friend Mask greater(Pack a, Pack b) { return Mask{ _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+        friend Mask less(Pack a, Pack b) { return Mask{ _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+        friend Pack select(Mask m, Pack a, Pack b) { return Pack{ _mm256_blendv_ps(b.v, a.v, m.m) }; }
+    };
+
+    template<>
+    struct Pack<double, 4>
+    {
+        using Scalar = double;
+        static constexpr int lanes = 4;
+
+        struct Mask
+        {
+            __m256d m;
+
+            friend Mask operator&(Mask a, Mask b) { return Mask{ _mm256_and_pd(a.m, b.m) }; }
+            friend Mask operator|(Mask a, Mask b) { return Mask{ _mm256_or_pd(a.m, b.m) }; }
+            friend Mask operator!(Mask a) { return Mask{ _mm256_xor_pd(a.m, _mm256_castsi256_pd(_mm256_set1_epi64x(-1))) }; }
+            friend bool any(Mask a) { return _mm256_movemask_pd(a.m) != 0; }
+        };
+
+        __m256d v;
+
+        static Pack broadcast(double x) { return Pack{ _mm256_set1_pd(x) }; }
+        static Pack load(const double* p) { return Pack{ _mm256_loadu_pd(p) }; }
+        void store(double* p) const { _mm256_storeu_pd(p, v); }
+
+        friend Pack operator+(Pack a, Pack b) { return Pack{ _mm256_add_pd(a.v, b.v) }; }
+        friend Pack operator-(Pack a, Pack b) { return Pack{ _mm256_sub_pd(a.v, b.v) }; }
+        friend Pack operator*(Pack a, Pack b) { return Pack{ _mm256_mul_pd(a.v, b.v) }; }
+        friend Pack operator/(Pack a, Pack b) { return Pack{ _mm256_div_pd(a.v, b.v) }; }
+
+        friend Mask greater(Pack a, Pack b) { return Mask{ _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ) }; }
+        friend Mask less(Pack a, Pack b) { return Mask{ _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ) }; }
+        friend Pack select(Mask m, Pack a, Pack b) { return Pack{ _mm256_blendv_pd(b.v, a.v, m.m) }; }
+    };
+
+    using Float = Pack<float, 8>;
+    using Double = Pack<double, 4>;
+
+    /// <summary>
+    /// Name of the instruction set used by the packs
+    /// </summary>
+    inline constexpr const char* instructionSet = "AVX2";
+
+#else
+
+    using Float = Pack<float, 4>;
+    using Double = Pack<double, 4>;
+
+    /// <summary>
+    /// Name of the instruction set used by the packs
+    /// </summary>
+    inline constexpr const char* instructionSet = "scalar";
+
+#endif
+}
+}
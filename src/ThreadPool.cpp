@@ -0,0 +1,122 @@
+#include "ThreadPool.hpp"
+
+using std::lock_guard, std::unique_lock;
+
+ThreadPool::ThreadPool(int threadCount)
+    : _generation(0)
+    , _working(0)
+    , _stop(false)
+{
+    if (threadCount <= 0)
+        threadCount = (int)thread::hardware_concurrency();
+    if (threadCount <= 0)
+        threadCount = 1;
+
+    for (int i = 0; i < threadCount; i++)
+        _queues.emplace_back(new _Queue());
+
+    for (int i = 1; i < threadCount; i++)
+        _threads.emplace_back([this, i]() { _worker(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+
+    for (thread& t : _threads)
+        t.join();
+}
+
+int ThreadPool::threadCount()
+{
+    return (int)_queues.size();
+}
+
+void ThreadPool::parallelFor(int count, function<void(int)> job)
+{
+    {
+        lock_guard<mutex> lock(_mutex);
+        _job = job;
+
+        // dealing the jobs in order so that the first jobs of all threads are the first jobs overall
+        for (int i = 0; i < count; i++)
+        {
+            _Queue& queue = *_queues[i % _queues.size()];
+            lock_guard<mutex> queueLock(queue.access);
+            queue.jobs.push_back(i);
+        }
+
+        _working = (int)_threads.size();
+        _generation++;
+    }
+    _wake.notify_all();
+
+    _runJobs(0);
+
+    unique_lock<mutex> lock(_mutex);
+    _done.wait(lock, [this]() { return _working == 0; });
+    _job = nullptr;
+}
+
+void ThreadPool::_worker(int index)
+{
+    int generation = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(_mutex);
+            _wake.wait(lock, [this, generation]() { return _stop || _generation != generation; });
+            if (_stop)
+                return;
+            generation = _generation;
+        }
+
+        _runJobs(index);
+
+        lock_guard<mutex> lock(_mutex);
+        if (--_working == 0)
+            _done.notify_one();
+    }
+}
+
+void ThreadPool::_runJobs(int index)
+{
+    // no jobs are added while running, so when all queues are empty the thread is done
+    int job;
+    while (_pop(index, job) || _steal(index, job))
+        _job(job);
+}
+
+bool ThreadPool::_pop(int index, int& job)
+{
+    _Queue& queue = *_queues[index];
+    lock_guard<mutex> lock(queue.access);
+    if (queue.jobs.empty())
+        return false;
+
+    job = queue.jobs.front();
+    queue.jobs.pop_front();
+    return true;
+}
+
+bool ThreadPool::_steal(int index, int& job)
+{
+    // taking the last job of other thread, those are the ones it would get to last
+    int count = (int)_queues.size();
+    for (int i = 1; i < count; i++)
+    {
+        _Queue& queue = *_queues[(index + i) % count];
+        lock_guard<mutex> lock(queue.access);
+        if (queue.jobs.empty())
+            continue;
+
+        job = queue.jobs.back();
+        queue.jobs.pop_back();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <memory>
+
+using std::vector, std::thread, std::mutex, std::condition_variable, std::function, std::deque, std::unique_ptr;
+
+/// <summary>
+/// Threads that run indexed jobs in parallel (the calling thread also takes part),
+/// each thread has its own queue of jobs and steals from the others when it runs out
+/// </summary>
+class ThreadPool
+{
+public:
+    /// <summary>
+    /// Creates pool with the given number of threads
+    /// </summary>
+    /// <param name="threadCount">Number of threads including the calling thread (0 = number of cores)</param>
+    ThreadPool(int threadCount);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+    /// <summary>
+    /// Gets the number of threads that run the jobs
+    /// </summary>
+    /// <returns>Number of threads including the calling thread</returns>
+    int threadCount();
+    /// <summary>
+    /// Runs the job for every index from 0 to count and waits until all of them are done,
+    /// jobs with lower index are started first
+    /// </summary>
+    /// <param name="count">Number of jobs</param>
+    /// <param name="job">Function called with the index of the job</param>
+    void parallelFor(int count, function<void(int)> job);
+private:
+    struct _Queue
+    {
+        mutex access;
+        deque<int> jobs;
+    };
+
+    void _worker(int index);
+    void _runJobs(int index);
+    bool _pop(int index, int& job);
+    bool _steal(int index, int& job);
+
+    vector<thread> _threads;
+    // queue of each thread, the calling thread has index 0
+    vector<unique_ptr<_Queue>> _queues;
+
+    mutex _mutex;
+    condition_variable _wake;
+    condition_variable _done;
+
+    function<void(int)> _job;
+    // incremented for each parallelFor so that the workers know there is new work
+    int _generation;
+    // workers that didn't finish the current jobs yet
+    int _working;
+    bool _stop;
+};
@@ -0,0 +1,161 @@
+#include <glad/glad.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+
+#include "Tracer.hpp"
+
+using std::atomic, std::vector, std::ofstream, std::endl, std::max;
+using namespace std::chrono;
+
+namespace
+{
+    struct _Event
+    {
+        const char* name;
+        int arg;
+        int thread;
+        // nanoseconds since the start, end is 0 until the scope ends
+        int64_t cpuBegin;
+        int64_t cpuEnd;
+        // the queries of the event hold its timestamps
+        bool gpu;
+    };
+
+    atomic<bool> _enabled{ false };
+    // events are claimed by incrementing the count, the ring keeps the last ones
+    vector<_Event> _events;
+    atomic<int64_t> _eventCount{ 0 };
+
+    // two timestamp queries for each event
+    vector<unsigned int> _queries;
+    int _glThread = 0;
+
+    steady_clock::time_point _start;
+    // gpu timestamp minus the cpu time at the start, moves the gpu events onto the cpu timeline
+    int64_t _gpuOffset = 0;
+
+    atomic<int> _threadCount{ 0 };
+    thread_local int _thread = -1;
+
+    int64_t _now()
+    {
+        return duration_cast<nanoseconds>(steady_clock::now() - _start).count();
+    }
+
+    int _threadId()
+    {
+        if (_thread < 0)
+            _thread = _threadCount++;
+        return _thread;
+    }
+
+    void _writeEvent(ofstream& file, const _Event& event, const char* category, int pid, int tid, int64_t begin, int64_t end)
+    {
+        file << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":" << pid
+            << ",\"tid\":" << tid << ",\"ts\":" << begin / 1000.0 << ",\"dur\":" << (end - begin) / 1000.0;
+        if (event.arg >= 0)
+            file << ",\"args\":{\"arg\":" << event.arg << "}";
+        file << "}";
+    }
+}
+
+Tracer::Scope::Scope(const char* name, int arg) : _event(-1)
+{
+    if (!_enabled.load(std::memory_order_relaxed))
+        return;
+
+    _event = _eventCount.fetch_add(1, std::memory_order_relaxed);
+    _Event& event = _events[_event % _events.size()];
+    event.name = name;
+    event.arg = arg;
+    event.thread = _threadId();
+    event.cpuEnd = 0;
+    event.gpu = event.thread == _glThread;
+    if (event.gpu)
+        glQueryCounter(_queries[_event % _events.size() * 2], GL_TIMESTAMP);
+    event.cpuBegin = _now();
+}
+
+Tracer::Scope::~Scope()
+{
+    if (_event < 0 || !_enabled.load(std::memory_order_relaxed))
+        return;
+
+    _Event& event = _events[_event % _events.size()];
+    event.cpuEnd = _now();
+    if (event.gpu)
+        glQueryCounter(_queries[_event % _events.size() * 2 + 1], GL_TIMESTAMP);
+}
+
+void Tracer::start(int capacity)
+{
+    _events.assign(max(capacity, 1), _Event{});
+    _queries.resize(_events.size() * 2);
+    glCreateQueries(GL_TIMESTAMP, (int)_queries.size(), _queries.data());
+    _glThread = _threadId();
+
+    _start = steady_clock::now();
+    GLint64 gpuNow;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    _gpuOffset = gpuNow - _now();
+
+    _eventCount = 0;
+    _enabled = true;
+}
+
+bool Tracer::enabled()
+{
+    return _enabled;
+}
+
+bool Tracer::save(const string& path)
+{
+    ofstream file(path);
+    if (!file.is_open())
+        return false;
+
+    file << std::fixed;
+    file.precision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"CPU\"}},\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"GPU\"}},\n"
+        << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << _glThread << ",\"args\":{\"name\":\"Render\"}}";
+
+    // the oldest events were overwritten by the newest ones
+    int64_t count = _eventCount;
+    int64_t size = (int64_t)_events.size();
+    for (int64_t i = max(count - size, (int64_t)0); i < count; i++)
+    {
+        const _Event& event = _events[i % size];
+        if (event.cpuEnd == 0)
+            continue;
+        _writeEvent(file, event, "cpu", 1, event.thread, event.cpuBegin, event.cpuEnd);
+
+        if (event.gpu)
+        {
+            // waits for the commands of the event to finish
+            GLuint64 begin;
+            GLuint64 end;
+            glGetQueryObjectui64v(_queries[i % size * 2], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(_queries[i % size * 2 + 1], GL_QUERY_RESULT, &end);
+            _writeEvent(file, event, "gpu", 2, 0, (int64_t)begin - _gpuOffset, (int64_t)end - _gpuOffset);
+        }
+    }
+    file << "\n]}" << endl;
+    return file.good();
+}
+
+void Tracer::free()
+{
+    if (!_enabled)
+        return;
+
+    _enabled = false;
+    glDeleteQueries((int)_queries.size(), _queries.data());
+    _queries.clear();
+    _events.clear();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+using std::string;
+
+/// <summary>
+/// Records the timeline of the frames as scoped events in a ring buffer, the last events are written as Chrome trace
+/// (can be opened in Perfetto). Events of the thread with the OpenGL context also get GPU timestamps from queries.
+/// Recording doesn't lock and costs only a check when the tracer wasn't started
+/// </summary>
+class Tracer
+{
+public:
+    /// <summary>
+    /// Event that lasts from its creation until the end of the scope
+    /// </summary>
+    class Scope
+    {
+    public:
+        /// <summary>
+        /// Starts the event
+        /// </summary>
+        /// <param name="name">Name of the event, has to live until the trace is saved (string literal)</param>
+        /// <param name="arg">Number shown with the event (negative isn't shown)</param>
+        Scope(const char* name, int arg = -1);
+        /// <summary>
+        /// Ends the event
+        /// </summary>
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        // index of the recorded event (-1 = not recording)
+        int64_t _event;
+    };
+
+    /// <summary>
+    /// Starts recording on the thread with the OpenGL context, only the last events are kept
+    /// </summary>
+    /// <param name="capacity">Number of events kept</param>
+    static void start(int capacity);
+    /// <summary>
+    /// Checks whether the events are recorded
+    /// </summary>
+    /// <returns>True if the tracer was started</returns>
+    static bool enabled();
+    /// <summary>
+    /// Writes the kept events as Chrome trace event JSON, waits for their GPU timestamps
+    /// </summary>
+    /// <param name="path">Path to the file</param>
+    /// <returns>True if the file was written</returns>
+    static bool save(const string& path);
+    /// <summary>
+    /// Stops recording and deletes the queries
+    /// </summary>
+    static void free();
+};
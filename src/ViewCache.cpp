@@ -0,0 +1,156 @@
+#include <glad/glad.h>
+
+#include "ViewCache.hpp"
+
+bool operator==(const ViewKey& a, const ViewKey& b)
+{
+    return a.fractal == b.fractal && a.precision == b.precision
+        && a.scale == b.scale && a.iterations == b.iterations && a.periodicityTolerance == b.periodicityTolerance
+        && a.centerX == b.centerX && a.centerY == b.centerY && a.parameters == b.parameters;
+}
+
+ViewCache::ViewCache() : ViewCache(0, 0, 0, 0) {}
+
+ViewCache::ViewCache(int width, int height, size_t gpuBudget, size_t hostBudget)
+    : _width(width)
+    , _height(height)
+    , _imageSize((size_t)width * height * 2 * sizeof(int))
+    , _gpuBudget(gpuBudget)
+    , _hostBudget(hostBudget)
+    , _hits(0)
+{
+}
+
+void ViewCache::store(const ViewKey& key, unsigned int iterState)
+{
+    if (_imageSize == 0 || (_imageSize > _gpuBudget && _imageSize > _hostBudget))
+        return;
+
+    // the same view has the same state
+    auto cached = _find(key);
+    if (cached != _entries.end())
+    {
+        _entries.splice(_entries.begin(), _entries, cached);
+        return;
+    }
+
+    // the state is written by image stores of the shaders
+    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+    _Entry entry{ key, 0, {} };
+    if (_imageSize <= _gpuBudget)
+    {
+        entry.texture = _createTexture();
+        glCopyImageSubData(iterState, GL_TEXTURE_2D, 0, 0, 0, 0, entry.texture, GL_TEXTURE_2D, 0, 0, 0, 0, _width, _height, 1);
+    }
+    else
+    {
+        entry.host.resize((size_t)_width * _height * 2);
+        glGetTextureImage(iterState, 0, GL_RG_INTEGER, GL_INT, (GLsizei)_imageSize, entry.host.data());
+    }
+    _entries.push_front(std::move(entry));
+
+    _evict();
+}
+
+bool ViewCache::load(const ViewKey& key, unsigned int iterState)
+{
+    auto cached = _find(key);
+    if (cached == _entries.end())
+        return false;
+
+    _entries.splice(_entries.begin(), _entries, cached);
+    if (cached->texture != 0)
+        glCopyImageSubData(cached->texture, GL_TEXTURE_2D, 0, 0, 0, 0, iterState, GL_TEXTURE_2D, 0, 0, 0, 0, _width, _height, 1);
+    else
+    {
+        glTextureSubImage2D(iterState, 0, 0, 0, _width, _height, GL_RG_INTEGER, GL_INT, cached->host.data());
+
+        // the image is the most recent one now, so it goes back to the textures
+        if (_imageSize <= _gpuBudget)
+        {
+            cached->texture = _createTexture();
+            glCopyImageSubData(iterState, GL_TEXTURE_2D, 0, 0, 0, 0, cached->texture, GL_TEXTURE_2D, 0, 0, 0, 0, _width, _height, 1);
+            vector<int>().swap(cached->host);
+            _evict();
+        }
+    }
+
+    _hits++;
+    return true;
+}
+
+void ViewCache::clear()
+{
+    for (_Entry& entry : _entries)
+    {
+        if (entry.texture != 0)
+            glDeleteTextures(1, &entry.texture);
+    }
+    _entries.clear();
+}
+
+int ViewCache::count()
+{
+    return (int)_entries.size();
+}
+
+int ViewCache::hits()
+{
+    return _hits;
+}
+
+list<ViewCache::_Entry>::iterator ViewCache::_find(const ViewKey& key)
+{
+    for (auto entry = _entries.begin(); entry != _entries.end(); ++entry)
+    {
+        if (entry->key == key)
+            return entry;
+    }
+    return _entries.end();
+}
+
+unsigned int ViewCache::_createTexture()
+{
+    unsigned int texture;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    glTextureStorage2D(texture, 1, GL_RG32I, _width, _height);
+    return texture;
+}
+
+void ViewCache::_evict()
+{
+    // the most recent images fill the textures, the next ones the RAM and the rest is evicted
+    size_t gpu = 0;
+    size_t host = 0;
+    for (auto entry = _entries.begin(); entry != _entries.end();)
+    {
+        if (entry->texture != 0 && gpu + _imageSize <= _gpuBudget)
+        {
+            gpu += _imageSize;
+            ++entry;
+            continue;
+        }
+
+        bool fits = host + _imageSize <= _hostBudget;
+        if (entry->texture != 0)
+        {
+            // reading the texture waits for the gpu, which only happens when the textures are full
+            if (fits)
+            {
+                entry->host.resize((size_t)_width * _height * 2);
+                glGetTextureImage(entry->texture, 0, GL_RG_INTEGER, GL_INT, (GLsizei)_imageSize, entry->host.data());
+            }
+            glDeleteTextures(1, &entry->texture);
+            entry->texture = 0;
+        }
+
+        if (fits)
+        {
+            host += _imageSize;
+            ++entry;
+        }
+        else
+            entry = _entries.erase(entry);
+    }
+}
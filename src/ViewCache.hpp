@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include <list>
+#include <cstddef>
+#include <utility>
+
+#include "GLFractal.hpp"
+#include "FixedPoint.hpp"
+
+using std::vector, std::list;
+
+/// <summary>
+/// Everything the iterations of the main view depend on, cached images are reused only for exactly the same key
+/// </summary>
+struct ViewKey
+{
+    GLFractal::Fractal fractal{ GLFractal::Fractal::MANDELBROT };
+    // precision that was actually used (never AUTO)
+    GLFractal::Precision precision{ GLFractal::Precision::FLOAT };
+
+    FixedPoint centerX;
+    FixedPoint centerY;
+    double scale{ 4.0 };
+    int iterations{ 0 };
+    double periodicityTolerance{ 0.0 };
+
+    // constants, roots and coefficients used by the fractal
+    vector<double> parameters;
+
+    friend bool operator==(const ViewKey& a, const ViewKey& b);
+};
+
+/// <summary>
+/// Iteration states of finished images of the main view with least recently used eviction.
+/// Recent images are kept in textures, older ones are moved to the RAM before they are evicted
+/// </summary>
+class ViewCache
+{
+public:
+    /// <summary>
+    /// Creates cache that keeps nothing
+    /// </summary>
+    ViewCache();
+    /// <summary>
+    /// Creates cache for iteration states of the given size (RG32I textures)
+    /// </summary>
+    /// <param name="width">Width of the image in pixels</param>
+    /// <param name="height">Height of the image in pixels</param>
+    /// <param name="gpuBudget">Bytes of textures that can be kept</param>
+    /// <param name="hostBudget">Bytes of RAM that can be kept</param>
+    ViewCache(int width, int height, size_t gpuBudget, size_t hostBudget);
+    /// <summary>
+    /// Stores a copy of the iteration state of finished image, the least recently used images are moved to the RAM or evicted
+    /// </summary>
+    /// <param name="key">View the image was rendered with</param>
+    /// <param name="iterState">Texture with the iteration state</param>
+    void store(const ViewKey& key, unsigned int iterState);
+    /// <summary>
+    /// Copies the cached iteration state of the view into the texture
+    /// </summary>
+    /// <param name="key">View to look for</param>
+    /// <param name="iterState">Texture the state is copied into</param>
+    /// <returns>True if the view was cached</returns>
+    bool load(const ViewKey& key, unsigned int iterState);
+    /// <summary>
+    /// Deletes all cached images
+    /// </summary>
+    void clear();
+    /// <summary>
+    /// Gets the number of cached images
+    /// </summary>
+    /// <returns>Number of images in textures and in the RAM</returns>
+    int count();
+    /// <summary>
+    /// Gets the number of loads that found the view since the cache was created
+    /// </summary>
+    /// <returns>Number of hits</returns>
+    int hits();
+private:
+    struct _Entry
+    {
+        ViewKey key;
+        // 0 when the state was moved to the RAM
+        unsigned int texture;
+        vector<int> host;
+    };
+
+    list<_Entry>::iterator _find(const ViewKey& key);
+    unsigned int _createTexture();
+    void _evict();
+
+    int _width;
+    int _height;
+    size_t _imageSize;
+    size_t _gpuBudget;
+    size_t _hostBudget;
+
+    // most recently used first
+    list<_Entry> _entries;
+    int _hits;
+};
@@ -0,0 +1,11 @@
+#version 460 core
+out vec4 FragColor;
+
+// sum of the colors of all samples of the marked pixels
+uniform sampler2D samples;
+uniform float sampleCount;
+
+void main()
+{
+    FragColor = vec4(texelFetch(samples, ivec2(gl_FragCoord.xy), 0).rgb / sampleCount, 1.0);
+}
\ No newline at end of file
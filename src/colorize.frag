@@ -0,0 +1,123 @@
+#version 460 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+// number of iterations and result of each pixel written by the fractal shaders
+layout(binding = 1, rg32i) uniform readonly iimage2D iterState;
+
+uniform sampler2D texture1;
+uniform dvec2 center;
+uniform double scale;
+uniform int iter;
+uniform vec3 color;
+uniform float colorCount;
+
+// 0 = escape time (mandelbrot, julia), 1 = newton, 2 = nova
+uniform int mode;
+
+// last finished image, shown for the pixels that are not iterated to the end yet after the view has moved or zoomed
+uniform sampler2D preview;
+uniform bool usePreview;
+// pixel of the preview is (pixel - renderSize / 2) * previewRatio + renderSize / 2 + previewOffset,
+// the image is smaller than the view when it is rendered at lower resolution
+uniform vec2 renderSize;
+uniform float previewRatio;
+uniform vec2 previewOffset;
+
+// parameters shared by all shaders
+layout(std140, binding = 0) uniform Parameters
+{
+    vec2 roots[10];
+    vec2 coefs[11];
+    vec2 constants[10];
+    int rootCount;
+    int coefCount;
+    int constantCount;
+};
+
+vec4 escapeTime(int i, int result);
+vec4 newton(int i, int result);
+vec4 nova(int result);
+vec4 previewColor();
+
+void main()
+{
+    ivec2 state = imageLoad(iterState, ivec2(gl_FragCoord.xy)).xy;
+
+    // nova pixels have a root until the last iteration, the others only once they are done
+    if (usePreview && state.x < iter && (mode == 2 || state.y == 0))
+    {
+        FragColor = previewColor();
+        return;
+    }
+
+    switch (mode)
+    {
+    case 0:
+        FragColor = escapeTime(state.x, state.y);
+        break;
+    case 1:
+        FragColor = newton(state.x, state.y);
+        break;
+    default:
+        FragColor = nova(state.y);
+        break;
+    }
+}
+
+vec4 escapeTime(int i, int result)
+{
+    // result is 1 for escaped points, inside points are 0 (not escaped yet) or 2 (z is cycling)
+    return result == 1 ? texture(texture1, vec2(float(i) / colorCount)) : vec4(color, 1.0);
+}
+
+vec4 newton(int i, int result)
+{
+    if (rootCount == 0)
+        return vec4(color, 1.0);
+
+    // root index is stored with offset so that 0 means not converged
+    int c = max(result - 1, 0);
+
+    vec4 col = result == 0 || i >= iter ? vec4(0) : texture(texture1, vec2(float(c) / rootCount)) * (1.0 - (i / float(iter)));
+    col.w = 1.0;
+
+    dvec2 z = dvec2((TexCoord.y - 0.5lf) * scale - center.x, (TexCoord.x - 0.5lf) * scale - center.y);
+    double zDist = length(z - roots[c]);
+    if (zDist < (0.007 * scale) && zDist > (0.004 * scale))
+    {
+        col = vec4(1.0 - col.x, 1.0 - col.y, 1.0 - col.z, 1.0);
+    }
+    return col;
+}
+
+vec4 nova(int result)
+{
+    if (rootCount == 0)
+        return vec4(color, 1.0);
+
+    int c = max(result - 1, 0);
+
+    vec4 col = texture(texture1, vec2(float(c) / rootCount));
+
+    dvec2 z = dvec2((TexCoord.y - 0.5lf) * scale - center.x, (TexCoord.x - 0.5lf) * scale - center.y);
+    for (int i = 0; i < rootCount; i++)
+    {
+        double zDist = length(z - roots[i]);
+        if (zDist < (0.007 * scale) && zDist > (0.004 * scale))
+        {
+            col = vec4(1.0 - col.x, 1.0 - col.y, 1.0 - col.z, 1.0);
+            break;
+        }
+    }
+    return col;
+}
+
+vec4 previewColor()
+{
+    vec2 position = (gl_FragCoord.xy - renderSize / 2.0) * previewRatio + renderSize / 2.0 + previewOffset;
+    if (any(lessThan(position, vec2(0.0))) || any(greaterThanEqual(position, renderSize)))
+        return vec4(color, 1.0);
+    return texture(preview, position / renderSize);
+}
\ No newline at end of file
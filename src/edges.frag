@@ -0,0 +1,48 @@
+#version 460 core
+// marks the pixels of the main view that are antialiased, the pixels that are not
+// discarded set the stencil buffer and are counted
+
+// iteration state written by the fractal shaders
+layout(binding = 1, rg32i) uniform readonly iimage2D iterState;
+// number of marked pixels
+layout(binding = 0, offset = 0) uniform atomic_uint edgeCount;
+
+// 0 = escape time (mandelbrot, julia), 1 = newton, 2 = nova
+uniform int mode;
+
+// the neighbors can have very different colors (see colorize.frag)
+bool differs(ivec2 a, ivec2 b)
+{
+    switch (mode)
+    {
+    case 0:
+        // inside points have the same color however they were found, escaped points
+        // one iteration apart are neighboring color bands
+        return (a.y == 1) != (b.y == 1) || (a.y == 1 && abs(a.x - b.x) > 1);
+    case 1:
+        return a.y != b.y || abs(a.x - b.x) > 1;
+    default:
+        // nova is colored only by the root
+        return a.y != b.y;
+    }
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    ivec2 last = imageSize(iterState) - 1;
+    ivec2 state = imageLoad(iterState, pixel).xy;
+
+    for (int y = -1; y <= 1; y++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            if (differs(state, imageLoad(iterState, clamp(pixel + ivec2(x, y), ivec2(0), last)).xy))
+            {
+                atomicCounterIncrement(edgeCount);
+                return;
+            }
+        }
+    }
+    discard;
+}
\ No newline at end of file
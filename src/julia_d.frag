@@ -1,32 +1,85 @@
 #version 460 core
-out vec4 FragColor;
-
+// tiles.comp compiles this shader as a compute shader with its own pixel and texture coordinates
+#ifndef TILED
 in vec2 TexCoord;
+#define PIXEL ivec2(gl_FragCoord.xy)
+// antialiasing passes iterate only the pixels that pass the stencil test
+layout(early_fragment_tests) in;
+#endif
+
+// iteration state of each pixel, the fractal is iterated over multiple frames
+// and colored by colorize.frag
+layout(binding = 0, rgba32ui) uniform uimage2D zState;
+layout(binding = 1, rg32i) uniform iimage2D iterState;
 
-uniform sampler2D texture1;
 uniform dvec2 center;
 uniform double scale;
-uniform int iter;
-uniform vec3 color;
-uniform float colorCount;
+uniform int iterStart;
+uniform int iterEnd;
+// largest distance from an earlier z that is taken as a cycle (0 disables periodicity checking)
+uniform double periodTolerance;
 uniform dvec2 constant;
 
 void main()
 {
+    ivec2 pixel = PIXEL;
+
     dvec2 z;
     z.x = (TexCoord.y - 0.5lf) * scale - center.x;
     z.y = (TexCoord.x - 0.5lf) * scale - center.y;
 
-    int i;
-    for (i = 0; i < iter; i++)
-    {
-        double x = (z.x * z.x - z.y * z.y) + constant.x;
-        double y = (z.y * z.x + z.x * z.y) + constant.y;
+    int i = 0;
+    bool escaped = false;
+    // found to be inside the set, z is cycling
+    bool interior = false;
 
-        if ((x * x + y * y) > 4.0) break;
-        z.x = x;
-        z.y = y;
+    if (iterStart != 0)
+    {
+        ivec2 state = imageLoad(iterState, pixel).xy;
+        i = state.x;
+        // result is 1 for escaped points and 2 for points that are inside the set
+        escaped = state.y == 1;
+        interior = state.y == 2;
+        uvec4 zBits = imageLoad(zState, pixel);
+        z = dvec2(packDouble2x32(zBits.xy), packDouble2x32(zBits.zw));
     }
 
-    FragColor = i == iter ? vec4(color, 1.0) : texture(texture1, vec2(float(i) / colorCount));
+    if (!escaped && !interior)
+    {
+        // Brent's cycle detection, z is compared with a saved z that is moved after 1, 2, 4, 8... iterations
+        dvec2 saved = z;
+        int savedAfter = 1;
+        int sinceSaved = 0;
+        double tolerance = periodTolerance * periodTolerance;
+
+        for (; i < iterEnd; i++)
+        {
+            double x = (z.x * z.x - z.y * z.y) + constant.x;
+            double y = (z.y * z.x + z.x * z.y) + constant.y;
+
+            if ((x * x + y * y) > 4.0)
+            {
+                escaped = true;
+                break;
+            }
+            z.x = x;
+            z.y = y;
+
+            dvec2 d = z - saved;
+            if (dot(d, d) < tolerance)
+            {
+                interior = true;
+                break;
+            }
+            if (++sinceSaved == savedAfter)
+            {
+                saved = z;
+                sinceSaved = 0;
+                savedAfter *= 2;
+            }
+        }
+
+        imageStore(zState, pixel, uvec4(unpackDouble2x32(z.x), unpackDouble2x32(z.y)));
+        imageStore(iterState, pixel, ivec4(i, escaped ? 1 : interior ? 2 : 0, 0, 0));
+    }
 }
\ No newline at end of file
@@ -0,0 +1,156 @@
+#version 460 core
+// tiles.comp compiles this shader as a compute shader with its own pixel and texture coordinates
+#ifndef TILED
+in vec2 TexCoord;
+#define PIXEL ivec2(gl_FragCoord.xy)
+// antialiasing passes iterate only the pixels that pass the stencil test
+layout(early_fragment_tests) in;
+#endif
+
+// iteration state of each pixel, the fractal is iterated over multiple frames
+// and colored by colorize.frag
+layout(binding = 0, rgba32ui) uniform uimage2D zState;
+layout(binding = 1, rg32i) uniform iimage2D iterState;
+
+// double-float numbers are stored as unevaluated sums of two floats (high part, low part),
+// complex numbers as (real high, real low, imaginary high, imaginary low)
+uniform vec4 center;
+uniform vec2 scale;
+uniform int iterStart;
+uniform int iterEnd;
+// largest distance from an earlier z that is taken as a cycle (0 disables periodicity checking)
+uniform float periodTolerance;
+uniform vec4 constant;
+
+vec2 dfAdd(vec2 a, vec2 b);
+vec2 dfSub(vec2 a, vec2 b);
+vec2 dfMul(vec2 a, vec2 b);
+vec2 dfMulF(vec2 a, float b);
+
+void main()
+{
+    ivec2 pixel = PIXEL;
+
+    vec2 zx = dfSub(dfMulF(scale, TexCoord.y - 0.5), center.xy);
+    vec2 zy = dfSub(dfMulF(scale, TexCoord.x - 0.5), center.zw);
+
+    int i = 0;
+    bool escaped = false;
+    // found to be inside the set, z is cycling
+    bool interior = false;
+
+    if (iterStart != 0)
+    {
+        ivec2 state = imageLoad(iterState, pixel).xy;
+        i = state.x;
+        // result is 1 for escaped points and 2 for points that are inside the set
+        escaped = state.y == 1;
+        interior = state.y == 2;
+        vec4 z = uintBitsToFloat(imageLoad(zState, pixel));
+        zx = z.xy;
+        zy = z.zw;
+    }
+
+    if (!escaped && !interior)
+    {
+        // Brent's cycle detection, z is compared with a saved z that is moved after 1, 2, 4, 8... iterations
+        vec2 savedX = zx;
+        vec2 savedY = zy;
+        int savedAfter = 1;
+        int sinceSaved = 0;
+        float tolerance = periodTolerance * periodTolerance;
+
+        for (; i < iterEnd; i++)
+        {
+            vec2 x = dfAdd(dfSub(dfMul(zx, zx), dfMul(zy, zy)), constant.xy);
+            vec2 y = dfAdd(dfMulF(dfMul(zx, zy), 2.0), constant.zw);
+
+            // the low parts can't change the result of the bailout test
+            if ((x.x * x.x + y.x * y.x) > 4.0)
+            {
+                escaped = true;
+                break;
+            }
+            zx = x;
+            zy = y;
+
+            vec2 d = vec2(dfSub(zx, savedX).x, dfSub(zy, savedY).x);
+            if (dot(d, d) < tolerance)
+            {
+                interior = true;
+                break;
+            }
+            if (++sinceSaved == savedAfter)
+            {
+                savedX = zx;
+                savedY = zy;
+                sinceSaved = 0;
+                savedAfter *= 2;
+            }
+        }
+
+        imageStore(zState, pixel, floatBitsToUint(vec4(zx, zy)));
+        imageStore(iterState, pixel, ivec4(i, escaped ? 1 : interior ? 2 : 0, 0, 0));
+    }
+}
+
+// sum of a and b without rounding error (Knuth)
+vec2 twoSum(float a, float b)
+{
+    precise float s = a + b;
+    precise float v = s - a;
+    precise float e = (a - (s - v)) + (b - v);
+    return vec2(s, e);
+}
+
+// same as twoSum when |a| >= |b| (Dekker)
+vec2 quickTwoSum(float a, float b)
+{
+    precise float s = a + b;
+    precise float e = b - (s - a);
+    return vec2(s, e);
+}
+
+// splits float into two halves that can be multiplied without rounding (Dekker)
+vec2 split(float a)
+{
+    precise float t = 4097.0 * a;
+    precise float hi = t - (t - a);
+    precise float lo = a - hi;
+    return vec2(hi, lo);
+}
+
+// product of a and b without rounding error (Dekker), fma isn't exact on all drivers
+vec2 twoProd(float a, float b)
+{
+    vec2 as = split(a);
+    vec2 bs = split(b);
+    precise float p = a * b;
+    precise float e = ((as.x * bs.x - p) + as.x * bs.y + as.y * bs.x) + as.y * bs.y;
+    return vec2(p, e);
+}
+
+vec2 dfAdd(vec2 a, vec2 b)
+{
+    vec2 s = twoSum(a.x, b.x);
+    vec2 t = twoSum(a.y, b.y);
+    s = quickTwoSum(s.x, s.y + t.x);
+    return quickTwoSum(s.x, s.y + t.y);
+}
+
+vec2 dfSub(vec2 a, vec2 b)
+{
+    return dfAdd(a, -b);
+}
+
+vec2 dfMul(vec2 a, vec2 b)
+{
+    vec2 p = twoProd(a.x, b.x);
+    return quickTwoSum(p.x, p.y + (a.x * b.y + a.y * b.x));
+}
+
+vec2 dfMulF(vec2 a, float b)
+{
+    vec2 p = twoProd(a.x, b);
+    return quickTwoSum(p.x, p.y + a.y * b);
+}
@@ -0,0 +1,109 @@
+#version 460 core
+// tiles.comp compiles this shader as a compute shader with its own pixel and texture coordinates
+#ifndef TILED
+in vec2 TexCoord;
+#define PIXEL ivec2(gl_FragCoord.xy)
+// antialiasing passes iterate only the pixels that pass the stencil test
+layout(early_fragment_tests) in;
+#endif
+
+// iteration state of each pixel, the fractal is iterated over multiple frames
+// and colored by colorize.frag
+layout(binding = 0, rgba32ui) uniform uimage2D zState;
+layout(binding = 1, rg32i) uniform iimage2D iterState;
+// index of the reference orbit point that each pixel follows
+layout(binding = 2, r32i) uniform iimage2D refState;
+
+// orbit of the center of the view computed in high precision, starts at 0
+layout(std430, binding = 1) readonly buffer ReferenceOrbitF
+{
+    vec2 orbit[];
+};
+
+uniform float scale;
+uniform int orbitLength;
+// series approximation of dz after skipping the first iterations, dz = A * u + B * u^2 + C * u^3
+// where u is the position of the pixel in the view (scale is included in the coefficients)
+uniform vec2 seriesA;
+uniform vec2 seriesB;
+uniform vec2 seriesC;
+uniform int seriesSkip;
+uniform int iterStart;
+uniform int iterEnd;
+
+vec2 cMul(vec2 a, vec2 b);
+
+void main()
+{
+    ivec2 pixel = PIXEL;
+
+    // only the distance from the center is needed, the center is in the orbit
+    vec2 dc;
+    dc.x = (TexCoord.y - 0.5) * scale;
+    dc.y = (TexCoord.x - 0.5) * scale;
+
+    // z = orbit[m] + dz, z starts at c = orbit[1] + dc
+    int i = 0;
+    bool escaped = false;
+    int m = 1;
+    vec2 dz = dc;
+
+    if (iterStart == 0 && seriesSkip > 0)
+    {
+        vec2 u = vec2(TexCoord.y - 0.5, TexCoord.x - 0.5);
+        vec2 u2 = cMul(u, u);
+        i = seriesSkip;
+        m = seriesSkip + 1;
+        dz = cMul(seriesA, u) + cMul(seriesB, u2) + cMul(seriesC, cMul(u2, u));
+    }
+    else if (iterStart != 0)
+    {
+        ivec2 state = imageLoad(iterState, pixel).xy;
+        i = state.x;
+        escaped = state.y != 0;
+        dz = uintBitsToFloat(imageLoad(zState, pixel).xy);
+        m = imageLoad(refState, pixel).x;
+    }
+
+    if (!escaped)
+    {
+        for (; i < iterEnd; i++)
+        {
+            // z^2 + c - (Z^2 + C) = 2 * Z * dz + dz^2 + dc
+            vec2 ref = orbit[m];
+            dz = vec2(
+                2.0 * (ref.x * dz.x - ref.y * dz.y) + (dz.x * dz.x - dz.y * dz.y) + dc.x,
+                2.0 * (ref.x * dz.y + ref.y * dz.x) + 2.0 * dz.x * dz.y + dc.y
+            );
+            m++;
+
+            vec2 z = orbit[m] + dz;
+            float dist = dot(z, z);
+            if (dist > 4.0)
+            {
+                escaped = true;
+                break;
+            }
+
+            // when the pixel gets closer to 0 than to the reference (or the reference ends),
+            // the orbit is followed again from its start which avoids glitches
+            if (dist < dot(dz, dz) || m == orbitLength - 1)
+            {
+                dz = z;
+                m = 0;
+            }
+        }
+
+        imageStore(zState, pixel, uvec4(floatBitsToUint(dz), 0, 0));
+        imageStore(iterState, pixel, ivec4(i, escaped ? 1 : 0, 0, 0));
+        imageStore(refState, pixel, ivec4(m, 0, 0, 0));
+    }
+}
+
+vec2 cMul(vec2 a, vec2 b)
+{
+    return vec2(
+        a.x * b.x - a.y * b.y,
+        a.x * b.y + a.y * b.x
+    );
+}
\ No newline at end of file
@@ -9,7 +9,6 @@ uniform float scale;
 uniform int iter;
 uniform vec3 color;
 uniform float colorCount;
-uniform vec2 constant;
 
 void main()
 {
@@ -30,12 +29,5 @@ void main()
         z.y = y;
     }
 
-    vec2 dif = c - constant;
-    float dist = length(dif);
-    vec4 col = i == iter ? vec4(color, 1.0) : texture(texture1, vec2(float(i) / colorCount));
-    if (dist < (0.007 * scale) && dist > (0.004 * scale))
-    {
-        col = vec4(1.0 - col.x, 1.0 - col.y, 1.0 - col.z, 1.0);
-    }
-    FragColor = col;
+    FragColor = i == iter ? vec4(color, 1.0) : texture(texture1, vec2(float(i) / colorCount));
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#version 460 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D texture1;
+uniform vec2 center;
+uniform float scale;
+uniform int markerCount;
+// markers are colored by the gradient, otherwise they are white and invert the selector by blending
+uniform bool gradient;
+
+// parameters shared by all shaders
+layout(std140, binding = 0) uniform Parameters
+{
+    vec2 roots[10];
+    vec2 coefs[11];
+    vec2 constants[10];
+    int rootCount;
+    int coefCount;
+    int constantCount;
+};
+
+void main()
+{
+    vec2 pos = vec2((TexCoord.y - 0.5) * scale - center.x, (TexCoord.x - 0.5) * scale - center.y);
+
+    for (int i = 0; i < markerCount; i++)
+    {
+        float dist = length(pos - constants[i]);
+        if (dist < (0.007 * scale) && dist > (0.004 * scale))
+        {
+            if (gradient)
+            {
+                FragColor = texture(texture1, vec2(float(i) / markerCount)) * 2;
+                FragColor.w *= 0.5;
+            }
+            else
+                FragColor = vec4(1.0);
+            return;
+        }
+    }
+    discard;
+}
\ No newline at end of file
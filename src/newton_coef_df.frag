@@ -0,0 +1,219 @@
+#version 460 core
+// tiles.comp compiles this shader as a compute shader with its own pixel and texture coordinates
+#ifndef TILED
+in vec2 TexCoord;
+#define PIXEL ivec2(gl_FragCoord.xy)
+// antialiasing passes iterate only the pixels that pass the stencil test
+layout(early_fragment_tests) in;
+#endif
+
+// iteration state of each pixel, the fractal is iterated over multiple frames
+// and colored by colorize.frag
+layout(binding = 0, rgba32ui) uniform uimage2D zState;
+layout(binding = 1, rg32i) uniform iimage2D iterState;
+
+// double-float numbers are stored as unevaluated sums of two floats (high part, low part),
+// complex numbers as (real high, real low, imaginary high, imaginary low)
+uniform vec4 center;
+uniform vec2 scale;
+uniform int iterStart;
+uniform int iterEnd;
+
+// parameters shared by all shaders
+layout(std140, binding = 0) uniform Parameters
+{
+    vec2 roots[10];
+    vec2 coefs[11];
+    vec2 constants[10];
+    int rootCount;
+    int coefCount;
+    int constantCount;
+};
+
+vec4 newtonRaphson(vec4 z);
+vec4 cAdd(vec4 a, vec4 b);
+vec4 cSub(vec4 a, vec4 b);
+vec4 cMul(vec4 a, vec4 b);
+vec4 cDiv(vec4 a, vec4 b);
+vec4 fun(vec4 z);
+vec4 deriv(vec4 z);
+vec2 dfAdd(vec2 a, vec2 b);
+vec2 dfSub(vec2 a, vec2 b);
+vec2 dfMul(vec2 a, vec2 b);
+vec2 dfMulF(vec2 a, float b);
+vec2 dfDiv(vec2 a, vec2 b);
+
+void main()
+{
+    if (rootCount == 0)
+        return;
+    ivec2 pixel = PIXEL;
+
+    vec4 z = vec4(dfSub(dfMulF(scale, TexCoord.y - 0.5), center.xy), dfSub(dfMulF(scale, TexCoord.x - 0.5), center.zw));
+	int c = 0;
+	int i = 0;
+    bool converged = false;
+
+    if (iterStart != 0)
+    {
+        ivec2 state = imageLoad(iterState, pixel).xy;
+        i = state.x;
+        // root index is stored with offset so that 0 means not converged
+        converged = state.y != 0;
+        c = max(state.y - 1, 0);
+        z = uintBitsToFloat(imageLoad(zState, pixel));
+    }
+
+    if (!converged)
+    {
+        while (i < iterEnd)
+        {
+            i++;
+            z = newtonRaphson(z);
+            // roots are only floats so the low parts don't matter here
+            float dist = length(roots[0] - z.xz);
+            c = 0;
+            for (int j = 1; j < rootCount; j++)
+            {
+                float newDist = length(roots[j] - z.xz);
+                if (newDist < dist)
+                {
+                    dist = newDist;
+                    c = j;
+                }
+            }
+            if (dist < 0.0001)
+            {
+                converged = true;
+                break;
+            }
+        }
+
+        imageStore(zState, pixel, floatBitsToUint(z));
+        imageStore(iterState, pixel, ivec4(i, converged ? c + 1 : 0, 0, 0));
+    }
+}
+
+vec4 newtonRaphson(vec4 z)
+{
+    return cSub(z, cDiv(fun(z), deriv(z)));
+}
+
+vec4 cAdd(vec4 a, vec4 b)
+{
+    return vec4(dfAdd(a.xy, b.xy), dfAdd(a.zw, b.zw));
+}
+
+vec4 cSub(vec4 a, vec4 b)
+{
+    return vec4(dfSub(a.xy, b.xy), dfSub(a.zw, b.zw));
+}
+
+vec4 cMul(vec4 a, vec4 b)
+{
+    return vec4(
+        dfSub(dfMul(a.xy, b.xy), dfMul(a.zw, b.zw)),
+        dfAdd(dfMul(a.xy, b.zw), dfMul(a.zw, b.xy))
+    );
+}
+
+vec4 cDiv(vec4 a, vec4 b)
+{
+    vec2 div = dfAdd(dfMul(b.xy, b.xy), dfMul(b.zw, b.zw));
+    return vec4(
+        dfDiv(dfAdd(dfMul(a.xy, b.xy), dfMul(a.zw, b.zw)), div),
+        dfDiv(dfSub(dfMul(a.zw, b.xy), dfMul(a.xy, b.zw)), div)
+    );
+}
+
+vec4 fun(vec4 z)
+{
+    vec4 res = vec4(coefs[0].x, 0.0, coefs[0].y, 0.0);
+    for (int i = 1; i < coefCount; i++)
+    {
+        res = cAdd(cMul(res, z), vec4(coefs[i].x, 0.0, coefs[i].y, 0.0));
+    }
+    return res;
+}
+
+vec4 deriv(vec4 z)
+{
+    int coefc = coefCount - 1;
+    vec2 first = coefs[0] * coefc;
+    vec4 res = vec4(first.x, 0.0, first.y, 0.0);
+    for (int i = 1; i < coefc; i++)
+    {
+        vec2 coef = (coefc - i) * coefs[i];
+        res = cAdd(cMul(res, z), vec4(coef.x, 0.0, coef.y, 0.0));
+    }
+    return res;
+}
+
+// sum of a and b without rounding error (Knuth)
+vec2 twoSum(float a, float b)
+{
+    precise float s = a + b;
+    precise float v = s - a;
+    precise float e = (a - (s - v)) + (b - v);
+    return vec2(s, e);
+}
+
+// same as twoSum when |a| >= |b| (Dekker)
+vec2 quickTwoSum(float a, float b)
+{
+    precise float s = a + b;
+    precise float e = b - (s - a);
+    return vec2(s, e);
+}
+
+// splits float into two halves that can be multiplied without rounding (Dekker)
+vec2 split(float a)
+{
+    precise float t = 4097.0 * a;
+    precise float hi = t - (t - a);
+    precise float lo = a - hi;
+    return vec2(hi, lo);
+}
+
+// product of a and b without rounding error (Dekker), fma isn't exact on all drivers
+vec2 twoProd(float a, float b)
+{
+    vec2 as = split(a);
+    vec2 bs = split(b);
+    precise float p = a * b;
+    precise float e = ((as.x * bs.x - p) + as.x * bs.y + as.y * bs.x) + as.y * bs.y;
+    return vec2(p, e);
+}
+
+vec2 dfAdd(vec2 a, vec2 b)
+{
+    vec2 s = twoSum(a.x, b.x);
+    vec2 t = twoSum(a.y, b.y);
+    s = quickTwoSum(s.x, s.y + t.x);
+    return quickTwoSum(s.x, s.y + t.y);
+}
+
+vec2 dfSub(vec2 a, vec2 b)
+{
+    return dfAdd(a, -b);
+}
+
+vec2 dfMul(vec2 a, vec2 b)
+{
+    vec2 p = twoProd(a.x, b.x);
+    return quickTwoSum(p.x, p.y + (a.x * b.y + a.y * b.x));
+}
+
+vec2 dfMulF(vec2 a, float b)
+{
+    vec2 p = twoProd(a.x, b);
+    return quickTwoSum(p.x, p.y + a.y * b);
+}
+
+// long division with one correction step
+vec2 dfDiv(vec2 a, vec2 b)
+{
+    float q1 = a.x / b.x;
+    vec2 r = dfSub(a, dfMulF(b, q1));
+    return quickTwoSum(q1, r.x / b.x);
+}
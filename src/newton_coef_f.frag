@@ -1,19 +1,32 @@
 #version 460 core
-out vec4 FragColor;
-
+// tiles.comp compiles this shader as a compute shader with its own pixel and texture coordinates
+#ifndef TILED
 in vec2 TexCoord;
+#define PIXEL ivec2(gl_FragCoord.xy)
+// antialiasing passes iterate only the pixels that pass the stencil test
+layout(early_fragment_tests) in;
+#endif
+
+// iteration state of each pixel, the fractal is iterated over multiple frames
+// and colored by colorize.frag
+layout(binding = 0, rgba32ui) uniform uimage2D zState;
+layout(binding = 1, rg32i) uniform iimage2D iterState;
 
-uniform sampler2D texture1;
 uniform vec2 center;
 uniform float scale;
-uniform int iter;
-uniform vec3 color;
-
-uniform vec2[10] roots;
-uniform int rootCount;
+uniform int iterStart;
+uniform int iterEnd;
 
-uniform vec2[11] coefs;
-uniform int coefCount;
+// parameters shared by all shaders
+layout(std140, binding = 0) uniform Parameters
+{
+    vec2 roots[10];
+    vec2 coefs[11];
+    vec2 constants[10];
+    int rootCount;
+    int coefCount;
+    int constantCount;
+};
 
 vec2 newtonRaphson(vec2 z);
 vec2 cMul(vec2 a, vec2 b);
@@ -24,42 +37,51 @@ vec2 deriv(vec2 z);
 void main()
 {
     if (rootCount == 0)
-    {
-        FragColor = vec4(color, 1.0);
         return;
-    }
+    ivec2 pixel = PIXEL;
+
     vec2 z = vec2((TexCoord.y - 0.5) * scale - center.x, (TexCoord.x - 0.5) * scale - center.y);
-    vec2 zCopy = z;
 	int c = 0;
-	int i;
-    for (i = 1; i < iter + 1; i++)
+	int i = 0;
+    bool converged = false;
+
+    if (iterStart != 0)
     {
-        z = newtonRaphson(z);
-		float dist = length(roots[0] - z);
-		c = 0;
-		for (int j = 1; j < rootCount; j++)
-		{
-			float newDist = length(roots[j] - z);
-			if (newDist < dist)
-			{
-				dist = newDist;
-				c = j;
-			}
-		}
-		if (dist < 0.0001)
-			break;
+        ivec2 state = imageLoad(iterState, pixel).xy;
+        i = state.x;
+        // root index is stored with offset so that 0 means not converged
+        converged = state.y != 0;
+        c = max(state.y - 1, 0);
+        z = uintBitsToFloat(imageLoad(zState, pixel).xy);
     }
 
-    bool isC = false;
-
-    vec4 col = i >= iter ? vec4(0) : texture(texture1, vec2(float(c) / rootCount)) * (1.0 - (i / float(iter)));
-	col.w = 1.0;
-    float zDist = length(zCopy - roots[c]);
-    if (zDist < (0.007 * scale) && zDist > (0.004 * scale))
+    if (!converged)
     {
-        col = vec4(1.0 - col.x, 1.0 - col.y, 1.0 - col.z, 1.0);
+        while (i < iterEnd)
+        {
+            i++;
+            z = newtonRaphson(z);
+            float dist = length(roots[0] - z);
+            c = 0;
+            for (int j = 1; j < rootCount; j++)
+            {
+                float newDist = length(roots[j] - z);
+                if (newDist < dist)
+                {
+                    dist = newDist;
+                    c = j;
+                }
+            }
+            if (dist < 0.0001)
+            {
+                converged = true;
+                break;
+            }
+        }
+
+        imageStore(zState, pixel, uvec4(floatBitsToUint(z), 0, 0));
+        imageStore(iterState, pixel, ivec4(i, converged ? c + 1 : 0, 0, 0));
     }
-    FragColor = col;
 }
 
 vec2 newtonRaphson(vec2 z)
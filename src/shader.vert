@@ -4,8 +4,15 @@ layout (location = 1) in vec2 aTexCoord;
 
 out vec2 TexCoord;
 
+// offset of the texture coordinates, pixels on edges of the main view are antialiased
+// with several samples moved by less than a pixel (zero for everything else)
+layout(std140, binding = 1) uniform Sampling
+{
+    vec2 jitter;
+};
+
 void main()
 {
-    TexCoord = aTexCoord;
+    TexCoord = aTexCoord + jitter;
     gl_Position = vec4(aPos, 1.0);
 }
\ No newline at end of file